@@ -0,0 +1,186 @@
+#include "Artefakte.hpp"
+#include <math.h>
+
+#define VORLAGE_GROESSE   256
+#define RAUSCH_GROESSE    1024
+#define CODE_GRENZE       8191
+
+// Q15-Vorlagen, je eine Periode bzw. ein Ereignis
+static int16_t sinusVorlage[VORLAGE_GROESSE];
+static int16_t hannVorlage[VORLAGE_GROESSE];
+static int16_t lidschlagVorlage[VORLAGE_GROESSE];
+static int16_t popVorlage[VORLAGE_GROESSE];
+static int16_t rauschVorlage[RAUSCH_GROESSE];
+static bool vorlagenBereit = false;
+
+static inline uint32_t xorshift32(uint32_t& x) {
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+static inline int16_t q15(double wert) {
+  long q = lround(wert * 32767.0);
+  if (q > 32767) q = 32767;
+  if (q < -32767) q = -32767;
+  return (int16_t)q;
+}
+
+bool KanalArtefakte::aktiv() const {
+  for (const ArtefaktEinstellung& e : typ) {
+    if (e.aktiv && e.amplitudeMv != 0.0f) return true;
+  }
+  return false;
+}
+
+void initArtefaktVorlagen() {
+  if (vorlagenBereit) return;
+  for (int i = 0; i < VORLAGE_GROESSE; ++i) {
+    double t = (double)i / VORLAGE_GROESSE;
+    sinusVorlage[i] = q15(sin(2.0 * M_PI * t));
+    hannVorlage[i] = q15(0.5 - 0.5 * cos(2.0 * M_PI * t));
+    // Gamma-Puls: schneller Anstieg, Maximum bei 30 % der Dauer, langsames Abklingen
+    double x = t / 0.3;
+    lidschlagVorlage[i] = q15(pow(x, 3.0) * exp(3.0 * (1.0 - x)));
+    // Sprung mit Abklingen auf ca. 0,7 % am Ende der Dauer
+    popVorlage[i] = q15(exp(-5.0 * t));
+  }
+  // Hochpassgefiltertes (differenziertes) weißes Rauschen, auf ±1 normiert
+  uint32_t x = 0x1234567;
+  int32_t vorher = 0;
+  double werte[RAUSCH_GROESSE];
+  double maximum = 1e-9;
+  for (int i = 0; i < RAUSCH_GROESSE; ++i) {
+    int32_t r = (int32_t)(xorshift32(x) >> 16) - 32768;
+    werte[i] = r - vorher;
+    vorher = r;
+    if (fabs(werte[i]) > maximum) maximum = fabs(werte[i]);
+  }
+  for (int i = 0; i < RAUSCH_GROESSE; ++i) rauschVorlage[i] = q15(werte[i] / maximum);
+  vorlagenBereit = true;
+}
+
+bool artefaktEinstellungGueltig(const ArtefaktEinstellung& e) {
+  if (!isfinite(e.amplitudeMv)) return false;
+  if (!(e.frequenzHz > 0.0f) || !(e.intervallS > 0.0f) || !(e.dauerS > 0.0f)) return false;
+  return true;
+}
+
+bool brummenDarstellbar(float frequenzHz, float ausgaberateHz) {
+  return frequenzHz < 0.5f * ausgaberateHz;
+}
+
+static uint32_t naechsterAbstand(ArtefaktZustand& z, uint32_t& zufall) {
+  uint32_t abstand = z.intervallSamples;
+  if (z.zufaellig) {
+    // Exponentialverteilter Abstand (nur beim Ereignisbeginn, nicht pro Sample)
+    float u = ((xorshift32(zufall) >> 8) + 1) * (1.0f / 16777217.0f);
+    abstand = (uint32_t)(-logf(u) * z.intervallSamples);
+  }
+  return abstand > 0 ? abstand : 1;
+}
+
+void bereiteArtefakteVor(const KanalArtefakte& einstellung, float codesProMv, float abtastrateHz,
+                         float ausgaberateHz, uint32_t startwert, KanalArtefaktZustand& zustand) {
+  initArtefaktVorlagen();
+  zustand = KanalArtefaktZustand();
+  zustand.zufall = startwert ? startwert : 1;
+  if (!(abtastrateHz > 0.0f)) abtastrateHz = 1.0f;
+  if (!(ausgaberateHz >= abtastrateHz)) ausgaberateHz = abtastrateHz;
+
+  for (int t = 0; t < ANZAHL_ARTEFAKTTYPEN; ++t) {
+    const ArtefaktEinstellung& e = einstellung.typ[t];
+    ArtefaktZustand& z = zustand.typ[t];
+    if (!e.aktiv || !artefaktEinstellungGueltig(e)) continue;
+    if (t == NETZBRUMMEN && !brummenDarstellbar(e.frequenzHz, ausgaberateHz)) continue;
+
+    float codes = e.amplitudeMv * codesProMv;
+    if (codes > CODE_GRENZE) codes = CODE_GRENZE;
+    if (codes < -CODE_GRENZE) codes = -CODE_GRENZE;
+    z.amplitudeCodes = (int32_t)lroundf(codes);
+    if (z.amplitudeCodes == 0) continue;
+
+    // Phaseninkrement: Netzbrummen eine Periode pro Vorlagendurchlauf im
+    // Ausgabetakt, Ereignisse eine Dauer im Quelltakt
+    double perioden = (t == NETZBRUMMEN) ? e.frequenzHz / ausgaberateHz : 1.0 / (e.dauerS * abtastrateHz);
+    if (perioden >= 0.5) perioden = 0.5;
+    z.schritt = (uint32_t)(perioden * 4294967296.0);
+    if (z.schritt == 0) z.schritt = 1;
+
+    z.zufaellig = e.zufaellig;
+    z.intervallSamples = (uint32_t)(e.intervallS * abtastrateHz);
+    z.countdown = naechsterAbstand(z, zustand.zufall);
+    z.laeuft = (t == NETZBRUMMEN);
+    zustand.aktiv = true;
+  }
+}
+
+// Ereignis-Artefakt: Vorlage einmal abspielen, danach auf das nächste Ereignis warten
+static void mischeEreignis(ArtefaktZustand& z, ArtefaktTyp typ, uint32_t& zufall, int32_t* summe, size_t anzahl) {
+  const int16_t* vorlage = (typ == LIDSCHLAG) ? lidschlagVorlage : (typ == ELEKTRODENPOP) ? popVorlage : hannVorlage;
+  for (size_t i = 0; i < anzahl; ++i) {
+    if (!z.laeuft) {
+      if (--z.countdown > 0) continue;
+      z.laeuft = true;
+      z.phase = 0;
+    }
+    int32_t wert = vorlage[z.phase >> 24];
+    if (typ == EMG) {
+      wert = (wert * rauschVorlage[z.rauschPos]) >> 15;
+      z.rauschPos = (z.rauschPos + 1) & (RAUSCH_GROESSE - 1);
+    }
+    summe[i] += (wert * z.amplitudeCodes) >> 15;
+
+    uint32_t naechste = z.phase + z.schritt;
+    if (naechste < z.phase) {
+      z.laeuft = false;
+      z.countdown = naechsterAbstand(z, zufall);
+    }
+    z.phase = naechste;
+  }
+}
+
+void mischeArtefakte(KanalArtefaktZustand& zustand, uint16_t* codes, size_t anzahl) {
+  if (!zustand.aktiv) return;
+
+  int32_t summe[64];
+  while (anzahl > 0) {
+    size_t n = anzahl > 64 ? 64 : anzahl;
+    for (size_t i = 0; i < n; ++i) summe[i] = codes[i];
+
+    for (int t = EMG; t < ANZAHL_ARTEFAKTTYPEN; ++t) {
+      if (zustand.typ[t].amplitudeCodes != 0) {
+        mischeEreignis(zustand.typ[t], (ArtefaktTyp)t, zustand.zufall, summe, n);
+      }
+    }
+
+    // Sättigung auf den DAC-Bereich
+    for (size_t i = 0; i < n; ++i) {
+      int32_t s = summe[i];
+      codes[i] = (uint16_t)(s < 0 ? 0 : (s > 4095 ? 4095 : s));
+    }
+    codes += n;
+    anzahl -= n;
+  }
+}
+
+void mischeBrummen(KanalArtefaktZustand& zustand, uint16_t* codes, size_t anzahl) {
+  ArtefaktZustand& brummen = zustand.typ[NETZBRUMMEN];
+  if (brummen.amplitudeCodes == 0) return;
+  for (size_t i = 0; i < anzahl; ++i) {
+    int32_t s = codes[i] + ((sinusVorlage[brummen.phase >> 24] * brummen.amplitudeCodes) >> 15);
+    codes[i] = (uint16_t)(s < 0 ? 0 : (s > 4095 ? 4095 : s));
+    brummen.phase += brummen.schritt;
+  }
+}
+
+const char* artefaktName(ArtefaktTyp typ) {
+  switch (typ) {
+    case NETZBRUMMEN:   return "hum";
+    case EMG:           return "emg";
+    case LIDSCHLAG:     return "blink";
+    case ELEKTRODENPOP: return "pop";
+    default:            return "";
+  }
+}
@@ -0,0 +1,75 @@
+#ifndef ARTEFAKTE_HPP
+#define ARTEFAKTE_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Echtzeit-Überlagerung typischer EEG-Artefakte auf die Kanaldaten.
+// Alle Verläufe liegen als vorberechnete Q15-Tabellen vor; gemischt wird
+// im DAC-Code-Bereich vor der Kalibrierung (Festkomma, sättigend). Die
+// Ereignisse laufen im Quelltakt vor dem Rekonstruktionsfilter, das
+// Netzbrummen im Ausgabetakt danach: so bleibt es auch bei niedriger
+// Quellrate (50 Hz bei 100 Hz) hörbar, sobald überabgetastet wird.
+
+enum ArtefaktTyp : uint8_t {
+  NETZBRUMMEN = 0,    // Dauerton 50/60 Hz
+  EMG,                // Muskelaktivität: Rauschen mit Hann-Hüllkurve
+  LIDSCHLAG,          // Augenblinzeln: asymmetrischer Puls
+  ELEKTRODENPOP,      // Sprung mit exponentiellem Abklingen
+  ANZAHL_ARTEFAKTTYPEN
+};
+
+struct ArtefaktEinstellung {
+  bool aktiv = false;
+  float amplitudeMv = 0.0f;   // Spitzenwert, Vorzeichen bestimmt die Richtung
+  float frequenzHz = 50.0f;   // nur Netzbrummen
+  float intervallS = 5.0f;    // Ereignisse: fester bzw. mittlerer Abstand
+  float dauerS = 0.4f;        // Ereignisse: Dauer eines Ereignisses
+  bool zufaellig = false;     // Ereignisse: Poisson-verteilter Abstand
+};
+
+struct KanalArtefakte {
+  ArtefaktEinstellung typ[ANZAHL_ARTEFAKTTYPEN];
+
+  bool aktiv() const;
+};
+
+// Laufzeitzustand eines Artefakts
+struct ArtefaktZustand {
+  int32_t amplitudeCodes = 0;
+  uint32_t phase = 0;          // Position in der Vorlage (oberste 8 Bit = Index)
+  uint32_t schritt = 0;        // Phaseninkrement pro Sample
+  uint32_t countdown = 0;      // Samples bis zum nächsten Ereignis
+  uint32_t intervallSamples = 0;
+  uint16_t rauschPos = 0;
+  bool laeuft = false;
+  bool zufaellig = false;
+};
+
+struct KanalArtefaktZustand {
+  ArtefaktZustand typ[ANZAHL_ARTEFAKTTYPEN];
+  uint32_t zufall = 1;         // xorshift32
+  bool aktiv = false;
+};
+
+// Berechnet die Vorlagen (einmalig beim Start)
+void initArtefaktVorlagen();
+
+bool artefaktEinstellungGueltig(const ArtefaktEinstellung& einstellung);
+// Netzbrummen nur unterhalb der halben Ausgaberate darstellbar
+bool brummenDarstellbar(float frequenzHz, float ausgaberateHz);
+
+// Rechnet Amplituden und Zeiten in Codes bzw. Samples um (beim Abspielstart);
+// abtastrateHz = Quelltakt, ausgaberateHz = Quelltakt * Überabtastung.
+// Nicht darstellbares Netzbrummen bleibt aus.
+void bereiteArtefakteVor(const KanalArtefakte& einstellung, float codesProMv, float abtastrateHz,
+                         float ausgaberateHz, uint32_t startwert, KanalArtefaktZustand& zustand);
+
+// Überlagert die Ereignis-Artefakte auf 'anzahl' unkalibrierte DAC-Codes im Quelltakt
+void mischeArtefakte(KanalArtefaktZustand& zustand, uint16_t* codes, size_t anzahl);
+// Überlagert das Netzbrummen auf 'anzahl' unkalibrierte DAC-Codes im Ausgabetakt
+void mischeBrummen(KanalArtefaktZustand& zustand, uint16_t* codes, size_t anzahl);
+
+const char* artefaktName(ArtefaktTyp typ);
+
+#endif // ARTEFAKTE_HPP
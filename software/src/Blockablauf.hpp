@@ -0,0 +1,50 @@
+#ifndef BLOCKABLAUF_HPP
+#define BLOCKABLAUF_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Ablauf der Wiedergabe über Blöcke und Segmente, ohne Arduino-Abhängigkeit
+// (Host-Test test/test_blockablauf). Ein Block umfasst höchstens 'block'
+// Quellsamples zu je 'faktor' Ausgabeframes. Der nächste Block – am
+// Segmentende der erste Block des nächsten Segments – wird direkt nach dem
+// letzten Frame des laufenden umgerechnet, noch vor dem Warten auf die Frist
+// seines ersten Frames. So wird jeder Frame, auch an Block- und
+// Segmentgrenzen, sofort nach dem Aufwachen geschrieben. Beim Aufruf ist der
+// erste Block des ersten Segments bereits gefüllt.
+//
+//   ablauf.abbrechen()                  vor jedem Block: true = Ende
+//   ablauf.frame(i, pos)                Frame 'pos' des Blocks ab Sample 'i'; false = Abbruch
+//   ablauf.segmentEnde()                nach jedem Quellsample: true = Segment hier beenden
+//   ablauf.naechstesSegment(laenge)     'laenge' enthält die gespielte Länge; false = Ende
+//   ablauf.fuelle(i, anzahl)            Block ab Sample 'i' umrechnen
+//   ablauf.warte(pos)                   bis zur Frist des nächsten Frames
+template <typename Ablauf>
+void spieleBloecke(Ablauf& ablauf, size_t laenge, size_t block, uint8_t faktor) {
+  size_t i = 0;
+  bool weiter = laenge > 0;
+  while (weiter && !ablauf.abbrechen()) {
+    size_t anzahl = (laenge - i < block) ? laenge - i : block;
+    for (size_t pos = 0; pos < anzahl * faktor; ++pos) {
+      if (!ablauf.frame(i, pos)) return;
+      if ((pos + 1) % faktor == 0 && ablauf.segmentEnde()) {
+        anzahl = pos / faktor + 1;
+        laenge = i + anzahl;
+      }
+      if (pos + 1 == anzahl * faktor) {
+        // Letzter Frame des Blocks ist geschrieben: nächsten vorbereiten
+        i += anzahl;
+        if (i >= laenge) {
+          i = 0;
+          do {
+            weiter = ablauf.naechstesSegment(laenge);
+          } while (weiter && laenge == 0);
+        }
+        if (weiter) ablauf.fuelle(i, (laenge - i < block) ? laenge - i : block);
+      }
+      ablauf.warte(pos);
+    }
+  }
+}
+
+#endif // BLOCKABLAUF_HPP
@@ -0,0 +1,91 @@
+#include "Bootablauf.hpp"
+#include <esp_timer.h>
+
+static BootPhase phasen[BOOT_PHASEN_MAX];
+static size_t phasenAnzahl = 0;
+static int64_t bereitUs[BOOT_ANZAHL_TEILE] = {-1, -1, -1};
+static volatile int64_t ersteAusgabeUs = -1;
+static portMUX_TYPE sperre = portMUX_INITIALIZER_UNLOCKED;
+
+static StaticEventGroup_t bereitGruppeSpeicher;
+static EventGroupHandle_t bereitGruppe = nullptr;
+
+static const char* const teilNamen[BOOT_ANZAHL_TEILE] = {"playback", "storage", "network"};
+
+void initBootablauf() {
+  if (bereitGruppe == nullptr) bereitGruppe = xEventGroupCreateStatic(&bereitGruppeSpeicher);
+}
+
+int beginneBootPhase(const char* name) {
+  const int64_t jetzt = esp_timer_get_time();
+  int index = -1;
+  portENTER_CRITICAL(&sperre);
+  if (phasenAnzahl < BOOT_PHASEN_MAX) {
+    index = (int)phasenAnzahl++;
+    phasen[index].name = name;
+    phasen[index].beginnUs = jetzt;
+    phasen[index].dauerUs = -1;
+    phasen[index].core = (int8_t)xPortGetCoreID();
+  }
+  portEXIT_CRITICAL(&sperre);
+  return index;
+}
+
+void beendeBootPhase(int index) {
+  if (index < 0) return;
+  const int64_t jetzt = esp_timer_get_time();
+  portENTER_CRITICAL(&sperre);
+  phasen[index].dauerUs = jetzt - phasen[index].beginnUs;
+  portEXIT_CRITICAL(&sperre);
+}
+
+void meldeBootBereit(EventBits_t teil) {
+  const int64_t jetzt = esp_timer_get_time();
+  for (uint8_t i = 0; i < BOOT_ANZAHL_TEILE; ++i) {
+    if ((teil & (1 << i)) && bereitUs[i] < 0) bereitUs[i] = jetzt;
+  }
+  xEventGroupSetBits(bereitGruppe, teil);
+}
+
+bool warteAufBoot(EventBits_t teile, TickType_t timeout) {
+  EventBits_t bits = xEventGroupWaitBits(bereitGruppe, teile, pdFALSE, pdTRUE, timeout);
+  return (bits & teile) == teile;
+}
+
+int64_t bootBereitUs(uint8_t teilIndex) {
+  return teilIndex < BOOT_ANZAHL_TEILE ? bereitUs[teilIndex] : -1;
+}
+
+const char* bootTeilName(uint8_t teilIndex) {
+  return teilIndex < BOOT_ANZAHL_TEILE ? teilNamen[teilIndex] : "";
+}
+
+void meldeErsteAusgabe() {
+  if (ersteAusgabeUs < 0) ersteAusgabeUs = esp_timer_get_time();
+}
+
+int64_t bootErsteAusgabeUs() {
+  return ersteAusgabeUs;
+}
+
+size_t leseBootZeitlinie(BootPhase* ziel, size_t maxAnzahl) {
+  portENTER_CRITICAL(&sperre);
+  size_t anzahl = phasenAnzahl < maxAnzahl ? phasenAnzahl : maxAnzahl;
+  for (size_t i = 0; i < anzahl; ++i) ziel[i] = phasen[i];
+  portEXIT_CRITICAL(&sperre);
+  return anzahl;
+}
+
+void gibBootZeitlinieAus() {
+  BootPhase kopie[BOOT_PHASEN_MAX];
+  size_t anzahl = leseBootZeitlinie(kopie, BOOT_PHASEN_MAX);
+  Serial.println("⏱️ Boot-Zeitlinie (µs ab Anwendungsstart):");
+  for (size_t i = 0; i < anzahl; ++i) {
+    Serial.printf("  %-24s Core %d  Beginn %8lld  Dauer %8lld\n", kopie[i].name, kopie[i].core,
+                  (long long)kopie[i].beginnUs, (long long)kopie[i].dauerUs);
+  }
+  for (uint8_t i = 0; i < BOOT_ANZAHL_TEILE; ++i) {
+    Serial.printf("  bereit: %-10s %8lld\n", teilNamen[i], (long long)bereitUs[i]);
+  }
+  if (ersteAusgabeUs >= 0) Serial.printf("  erstes Sample:     %8lld\n", (long long)ersteAusgabeUs);
+}
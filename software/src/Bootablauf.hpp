@@ -0,0 +1,47 @@
+#ifndef BOOTABLAUF_HPP
+#define BOOTABLAUF_HPP
+
+#include <Arduino.h>
+#include <freertos/event_groups.h>
+
+// Startablauf: setup() bringt DAC und Wiedergabe selbst hoch, Dateisystem und
+// WLAN/Webserver laufen parallel in eigenen Tasks auf Core 0. Jede Phase wird
+// mit Beginn und Dauer (µs ab Start der Anwendung) protokolliert; Ausgabe
+// über Serial und GET /boot.
+
+#define BOOT_PHASEN_MAX  16
+
+// Bereitschaft der einzelnen Teile
+#define BOOT_WIEDERGABE_BEREIT  (1 << 0)   // DAC, Kalibrierung, Abspiel-Task
+#define BOOT_SPEICHER_BEREIT    (1 << 1)   // SPIFFS eingebunden, Einstellungen geladen
+#define BOOT_NETZ_BEREIT        (1 << 2)   // SoftAP und Webserver laufen
+#define BOOT_ANZAHL_TEILE       3
+
+struct BootPhase {
+  const char* name = nullptr;
+  int64_t beginnUs = 0;
+  int64_t dauerUs = -1;    // -1 = läuft noch
+  int8_t core = -1;
+};
+
+// Als Erstes in setup() aufrufen
+void initBootablauf();
+
+// Liefert den Index für beendeBootPhase(); -1 wenn die Liste voll ist
+int beginneBootPhase(const char* name);
+void beendeBootPhase(int index);
+
+void meldeBootBereit(EventBits_t teil);
+bool warteAufBoot(EventBits_t teile, TickType_t timeout);
+// Zeitpunkt der Bereitschaft eines Teils (Bit-Index 0..2), -1 = noch nicht
+int64_t bootBereitUs(uint8_t teilIndex);
+const char* bootTeilName(uint8_t teilIndex);
+
+// Erste DAC-Übernahme seit dem Start (vom Abspiel-Task, nur der erste Aufruf zählt)
+void meldeErsteAusgabe();
+int64_t bootErsteAusgabeUs();     // -1 = noch keine Ausgabe
+
+size_t leseBootZeitlinie(BootPhase* ziel, size_t maxAnzahl);
+void gibBootZeitlinieAus();
+
+#endif // BOOTABLAUF_HPP
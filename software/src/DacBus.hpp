@@ -0,0 +1,94 @@
+#ifndef DACBUS_HPP
+#define DACBUS_HPP
+
+#include <stdint.h>
+#include "PinMapping.hpp"
+
+// Parallelbus zu BAUSTEINE DAC8412 als vorberechnete Set-/Clear-Masken:
+// ein Kanal wird mit einem Registerzugriff pro GPIO-Bank für Daten und Adresse
+// und einem Chip-Select-Puls geschrieben, ein Frame mit einem LDAC-Puls
+// übernommen. Ohne Arduino-Abhängigkeit; die Registerzugriffe liefert der
+// Aufrufer über 'Gpio' (DacRouting.cpp: GPIO-Register, test/test_dac_routing:
+// simulierte Bausteine).
+//
+//   Gpio::schreibe(const BusMaske&)            Clear-, dann Set-Masken beider Bänke
+//   Gpio::schreibeInvertiert(const BusMaske&)  Clear-Masken als Set (Puls beenden)
+//   Gpio::puls()                               Mindestdauer für CS/LDAC abwarten
+
+// Set-/Clear-Masken für beide GPIO-Bänke (GPIO 0–31 und 32–48)
+struct BusMaske {
+  uint32_t setzen0 = 0, loeschen0 = 0;
+  uint32_t setzen1 = 0, loeschen1 = 0;
+
+  void pin(uint8_t gpio, bool pegel) {
+    uint32_t bit = 1UL << (gpio & 31);
+    if (gpio < 32) (pegel ? setzen0 : loeschen0) |= bit;
+    else           (pegel ? setzen1 : loeschen1) |= bit;
+  }
+};
+
+template <uint8_t BAUSTEINE>
+struct DacBus {
+  // Datenwort in zwei Hälften zu je 6 Bit → 2 × 64 Einträge statt 4096
+  BusMaske datenNieder[64];
+  BusMaske datenHoch[64];
+  BusMaske adresse[KANAELE_PRO_DAC];
+  BusMaske chipSelect[BAUSTEINE];    // Pin aktiv (LOW) in loeschen*
+  BusMaske ldac;
+
+  void baue(const uint8_t datenPins[12], uint8_t add0, uint8_t add1, const uint8_t csPins[BAUSTEINE],
+            uint8_t ldacPin) {
+    for (uint8_t wert = 0; wert < 64; ++wert) {
+      datenNieder[wert] = BusMaske();
+      datenHoch[wert] = BusMaske();
+      for (uint8_t bit = 0; bit < 6; ++bit) {
+        datenNieder[wert].pin(datenPins[bit], (wert >> bit) & 0x01);
+        datenHoch[wert].pin(datenPins[bit + 6], (wert >> bit) & 0x01);
+      }
+    }
+    for (uint8_t a = 0; a < KANAELE_PRO_DAC; ++a) {
+      adresse[a] = BusMaske();
+      adresse[a].pin(add0, a & 0x01);
+      adresse[a].pin(add1, a & 0x02);
+    }
+    for (uint8_t d = 0; d < BAUSTEINE; ++d) {
+      chipSelect[d] = BusMaske();
+      chipSelect[d].pin(csPins[d], false);
+    }
+    ldac = BusMaske();
+    ldac.pin(ldacPin, false);
+  }
+
+  // Adress- und Datenleitungen eines Kanals in einem Wort
+  BusMaske wort(uint8_t kanal, uint16_t daten) const {
+    const BusMaske& nieder = datenNieder[daten & 0x3F];
+    const BusMaske& hoch = datenHoch[(daten >> 6) & 0x3F];
+    const BusMaske& adr = adresse[kanal % KANAELE_PRO_DAC];
+    BusMaske bus;
+    bus.setzen0 = nieder.setzen0 | hoch.setzen0 | adr.setzen0;
+    bus.loeschen0 = nieder.loeschen0 | hoch.loeschen0 | adr.loeschen0;
+    bus.setzen1 = nieder.setzen1 | hoch.setzen1 | adr.setzen1;
+    bus.loeschen1 = nieder.loeschen1 | hoch.loeschen1 | adr.loeschen1;
+    return bus;
+  }
+
+  // Eingangsregister eines Kanals (Baustein = kanal / 4, Adresse = kanal % 4)
+  template <typename Gpio>
+  inline void schreibe(Gpio& gpio, uint8_t kanal, uint16_t daten) const {
+    gpio.schreibe(wort(kanal, daten));
+    const BusMaske& cs = chipSelect[kanal / KANAELE_PRO_DAC];
+    gpio.schreibe(cs);
+    gpio.puls();
+    gpio.schreibeInvertiert(cs);
+  }
+
+  // LDAC-Puls: alle Bausteine übernehmen gleichzeitig
+  template <typename Gpio>
+  inline void uebernehmen(Gpio& gpio) const {
+    gpio.schreibe(ldac);
+    gpio.puls();
+    gpio.schreibeInvertiert(ldac);
+  }
+};
+
+#endif // DACBUS_HPP
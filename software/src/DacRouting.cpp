@@ -0,0 +1,90 @@
+#include "DacRouting.hpp"
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+
+// Mindestdauer für CS- und LDAC-Puls (tLDW ≥ 170 ns laut Datenblatt)
+#define DAC_PULS_NS  200
+
+static const uint8_t datenPins[12] = { DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7, DB8, DB9, DB10, DB11 };
+static const uint8_t csPins[DAC_ANZAHL] = DAC_CS_PINS;
+
+static DacBus<DAC_ANZAHL> bus;
+static BusMaske markerAn, markerAus;
+static uint32_t pulsTakte = 0;
+
+static inline void schreibeMaske(const BusMaske& m) {
+  REG_WRITE(GPIO_OUT_W1TC_REG, m.loeschen0);
+  REG_WRITE(GPIO_OUT1_W1TC_REG, m.loeschen1);
+  REG_WRITE(GPIO_OUT_W1TS_REG, m.setzen0);
+  REG_WRITE(GPIO_OUT1_W1TS_REG, m.setzen1);
+}
+
+// Inaktiv: Set- und Clear-Masken getauscht
+static inline void schreibeMaskeInvertiert(const BusMaske& m) {
+  REG_WRITE(GPIO_OUT_W1TS_REG, m.loeschen0);
+  REG_WRITE(GPIO_OUT1_W1TS_REG, m.loeschen1);
+}
+
+static inline void wartePuls() {
+  uint32_t start = ESP.getCycleCount();
+  while (ESP.getCycleCount() - start < pulsTakte) {}
+}
+
+// Registerzugriffe für DacBus
+struct GpioRegister {
+  static inline void schreibe(const BusMaske& m) { schreibeMaske(m); }
+  static inline void schreibeInvertiert(const BusMaske& m) { schreibeMaskeInvertiert(m); }
+  static inline void puls() { wartePuls(); }
+};
+static GpioRegister gpio;
+
+void initDacRouting() {
+  bus.baue(datenPins, ADD0, ADD1, csPins, Load_Data);
+  markerAn.pin(MARKER_PIN, HIGH);
+  markerAus.pin(MARKER_PIN, LOW);
+  pulsTakte = (uint32_t)ESP.getCpuFreqMHz() * DAC_PULS_NS / 1000;
+
+  digitalWrite(R_W, LOW);         // Nur Schreibzugriffe
+  digitalWrite(Load_Data, HIGH);  // Ausgänge erst mit dacFrameUebernehmen() aktualisieren
+}
+
+void ausgabe(uint8_t kanal, uint16_t Data) {
+  if (kanal >= ANZAHL_KANAELE) {
+    Serial.println("Ungültiger Kanal!");
+    return;
+  }
+  Data &= 0x0FFF; // Nur untere 12 Bit zulassen
+
+  // Adress- und Datenleitungen in einem Registerzugriff pro Bank, dann Chip-Select-Puls
+  bus.schreibe(gpio, kanal, Data);
+}
+
+void dacFrameUebernehmen() {
+  bus.uebernehmen(gpio);
+}
+
+uint32_t dacFrameMitMarker(bool pegel) {
+  uint32_t start = ESP.getCycleCount();
+  schreibeMaske(bus.ldac);
+  schreibeMaske(pegel ? markerAn : markerAus);
+  uint32_t takte = ESP.getCycleCount() - start;
+  wartePuls();
+  schreibeMaskeInvertiert(bus.ldac);
+  return takte;
+}
+
+int kanalIndexAusName(const String& name) {
+  if (!name.startsWith("CH_") || name.length() < 4) return -1;
+  int kanal = -1;
+  if (name.length() == 4 && name[3] >= 'A' && name[3] <= 'Z') {
+    kanal = name[3] - 'A';
+  } else {
+    kanal = name.substring(3).toInt() - 1;
+  }
+  return (kanal >= 0 && kanal < ANZAHL_KANAELE) ? kanal : -1;
+}
+
+String kanalName(uint8_t kanal) {
+  if (kanal < 26) return "CH_" + String((char)('A' + kanal));
+  return "CH_" + String(kanal + 1);
+}
@@ -0,0 +1,30 @@
+#ifndef DACROUTING_HPP
+#define DACROUTING_HPP
+
+#include <Arduino.h>
+#include "PinMapping.hpp"
+#include "DacBus.hpp"
+
+// Kanalindex 0 .. ANZAHL_KANAELE-1:
+//   Baustein = kanal / KANAELE_PRO_DAC  (Chip-Select aus DAC_CS_PINS)
+//   Adresse  = kanal % KANAELE_PRO_DAC  (ADD0/ADD1 → DAC A–D)
+
+// Bereitet die Registermasken vor und setzt R/W und LDAC in den Ruhezustand
+void initDacRouting();
+
+// Schreibt einen 12-Bit-Wert in das Eingangsregister eines Kanals.
+// Am Ausgang erscheint er erst mit dacFrameUebernehmen().
+void ausgabe(uint8_t kanal, uint16_t Data);
+
+// LDAC-Puls: übernimmt die Eingangsregister aller Bausteine gleichzeitig
+void dacFrameUebernehmen();
+
+// Wie dacFrameUebernehmen(), schaltet den Marker-Ausgang direkt nach der
+// LDAC-Flanke; liefert den Abstand beider Flanken in CPU-Takten
+uint32_t dacFrameMitMarker(bool pegel);
+
+// "CH_A" … "CH_Z", danach "CH_27" …; -1 bei unbekanntem Namen
+int kanalIndexAusName(const String& name);
+String kanalName(uint8_t kanal);
+
+#endif // DACROUTING_HPP
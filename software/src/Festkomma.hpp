@@ -0,0 +1,69 @@
+#ifndef FESTKOMMA_HPP
+#define FESTKOMMA_HPP
+
+#include <stdint.h>
+#include <limits>
+
+// Kleine Festkomma-Bibliothek für den Abspielpfad (ohne FPU, sättigend)
+//   Q15: int16_t, Wertebereich [-1, 1), Auflösung 2^-15
+//   Q31: int32_t, Wertebereich [-1, 1), Auflösung 2^-31
+// Alle Operationen rechnen im doppelt breiten Typ und sättigen am Ende,
+// statt überzulaufen. Multiplikation rundet zum nächsten Wert.
+
+// Begrenzt x auf den Wertebereich von Ziel
+template <typename Ziel, typename Quelle>
+static inline Ziel saettige(Quelle x) {
+  if (x > (Quelle)std::numeric_limits<Ziel>::max()) return std::numeric_limits<Ziel>::max();
+  if (x < (Quelle)std::numeric_limits<Ziel>::min()) return std::numeric_limits<Ziel>::min();
+  return (Ziel)x;
+}
+
+template <int BRUCHBITS, typename T, typename Breit>
+struct Festkomma {
+  static_assert(sizeof(Breit) >= 2 * sizeof(T), "Breit muss das Produkt aufnehmen");
+  static constexpr int bruchbits = BRUCHBITS;
+
+  T roh = 0;
+
+  static constexpr Festkomma ausRoh(T wert) {
+    Festkomma f;
+    f.roh = wert;
+    return f;
+  }
+
+  // Nur außerhalb des heißen Pfads (Laden, Vorbereiten)
+  static Festkomma ausFloat(float x) {
+    const float skaliert = x * (float)((Breit)1 << BRUCHBITS);
+    // NaN landet auf 0
+    if (!(skaliert == skaliert)) return ausRoh(0);
+    if (skaliert >= (float)std::numeric_limits<T>::max()) return ausRoh(std::numeric_limits<T>::max());
+    if (skaliert <= (float)std::numeric_limits<T>::min()) return ausRoh(std::numeric_limits<T>::min());
+    return ausRoh((T)(skaliert + (skaliert >= 0.0f ? 0.5f : -0.5f)));
+  }
+
+  float alsFloat() const { return (float)roh / (float)((Breit)1 << BRUCHBITS); }
+
+  friend Festkomma operator+(Festkomma a, Festkomma b) {
+    return ausRoh(saettige<T>((Breit)a.roh + (Breit)b.roh));
+  }
+  friend Festkomma operator-(Festkomma a, Festkomma b) {
+    return ausRoh(saettige<T>((Breit)a.roh - (Breit)b.roh));
+  }
+  // -1 * -1 sättigt auf knapp unter +1
+  friend Festkomma operator*(Festkomma a, Festkomma b) {
+    const Breit produkt = (Breit)a.roh * (Breit)b.roh + ((Breit)1 << (BRUCHBITS - 1));
+    return ausRoh(saettige<T>(produkt >> BRUCHBITS));
+  }
+  friend bool operator==(Festkomma a, Festkomma b) { return a.roh == b.roh; }
+  friend bool operator!=(Festkomma a, Festkomma b) { return a.roh != b.roh; }
+};
+
+using Q15 = Festkomma<15, int16_t, int32_t>;
+using Q31 = Festkomma<31, int32_t, int64_t>;
+
+// Sinus einer Phase (volle Umdrehung = 2^32) aus einer Vierteltabelle mit
+// gerundeter linearer Interpolation; Fehler höchstens 2 LSB (Q15,
+// test/test_festkomma)
+Q15 sinusQ15(uint32_t phase);
+
+#endif // FESTKOMMA_HPP
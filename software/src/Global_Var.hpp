@@ -7,10 +7,15 @@
 #include <SPIFFS.h>
 #include <DNSServer.h>
 #include <vector>
+#include <array>
 #include <map>
 #include <ArduinoJson.h>
 #include <regex>
 #include <cmath>
+#include "Skalierung.hpp"
+#include "PinMapping.hpp"
+#include "Marker.hpp"
+#include "Zahlenleser.hpp"
 
 // WiFi-Zugangsdaten
 //extern const char* ssid;
@@ -21,18 +26,50 @@ extern AsyncWebServer server;
 extern DNSServer dnsServer;
 
 // Strukturdefinitionen (einmalig hier!)
-struct FileData {
-  String filename;
+// Sinusgenerator als Signalquelle (z. B. 10 Hz Alpha), ersetzt die Samples
+struct SinusGenerator {
+  float frequenzHz = 0.0f;
+  float amplitudeMv = 0.0f;
+  Q15 amplitude;                // amplitudeMv als Anteil des Kanalbereichs (beim Laden)
+
+  bool aktiv() const { return amplitudeMv != 0.0f; }
+};
+
+// Geladene Samples eines Kanals (Q15 im Kanalbereich) samt Skalierung
+struct Kanal {
+  std::vector<Q15> samples;
+  KanalSkalierung skalierung;
+  bool schleife = false;        // Samples zyklisch wiederholen statt mit 0 mV aufzufüllen
+  // Lage auf der gemeinsamen Zeitachse; der Abspiel-Task tastet die Samples
+  // mit dem Ausgabetakt ab (lineare Interpolation), ohne Kopie
+  float abtastrateHz = 0.0f;    // eigene Abtastrate der Samples, 0 = Ausgabefrequenz
+  float versatzS = 0.0f;        // Beginn in s nach dem Start, davor 0 mV
+  SinusGenerator sinus;
+  std::vector<Marker> marker;   // nach Samplenummer sortiert
+
+  bool aktiv() const { return !samples.empty() || sinus.aktiv(); }
 };
 
+// Kanaltabelle in Hardware-Reihenfolge: Index = DAC-Kanal (siehe DacRouting.hpp)
+using KanalTabelle = std::array<Kanal, ANZAHL_KANAELE>;
+
+// Laufender Upload; feste Anzahl Plätze statt einer Map (siehe belegeUpload())
+#define UPLOAD_PLAETZE  8
+
 struct ActiveUpload {
-  File file;
+  AsyncWebServerRequest* request = nullptr;   // nullptr = Platz frei
+  File file;                    // Textdatei (entfällt bei convert=only)
   String path;
+  // Umwandlung in die .eegz-Fassung, während die Datei eintrifft
+  bool umwandeln = false;
+  bool nurUmgewandelt = false;  // convert=only: keine Textdatei als Rückfall
+  Zahlenleser leser;
+  std::vector<float> werte;     // beim ersten Stück fest reserviert, wächst nicht
+  std::vector<float> stueck;    // Zahlen eines Stücks (höchstens halb so viele wie Bytes)
 };
 
 // Globale Variablen
-extern std::map<String, std::vector<float>> kanalDaten;
-extern std::map<AsyncWebServerRequest*, ActiveUpload> activeUploads;
-extern std::vector<FileData> uploadedFiles;
+extern KanalTabelle kanalTabelle;
+extern std::array<ActiveUpload, UPLOAD_PLAETZE> activeUploads;
 
 #endif // GLOBAL_VAR_HPP
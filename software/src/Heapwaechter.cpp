@@ -0,0 +1,79 @@
+#include "Heapwaechter.hpp"
+#include <esp_heap_caps.h>
+
+static inline float fragmentierung(size_t frei, size_t groessterBlock) {
+  return frei ? 1.0f - (float)groessterBlock / (float)frei : 0.0f;
+}
+
+HeapStatistik holeHeapStatistik() {
+  HeapStatistik s;
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  s.frei = info.total_free_bytes;
+  s.groessterBlock = info.largest_free_block;
+  s.minimumFrei = info.minimum_free_bytes;
+  s.belegteBloecke = info.allocated_blocks;
+  s.freieBloecke = info.free_blocks;
+  s.fragmentierung = fragmentierung(s.frei, s.groessterBlock);
+  s.psramFrei = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+  s.psramGroessterBlock = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+  return s;
+}
+
+#ifdef HEAP_WAECHTER
+
+#include <esp_rom_sys.h>
+
+// Task der aktuellen heapfreien Zone (nullptr = keine)
+static TaskHandle_t volatile gesperrterTask = nullptr;
+
+extern "C" void* __real_malloc(size_t groesse);
+extern "C" void* __real_calloc(size_t anzahl, size_t groesse);
+extern "C" void* __real_realloc(void* zeiger, size_t groesse);
+
+static void pruefeAnforderung(const char* funktion, size_t groesse, void* aufrufer) {
+  if (gesperrterTask == nullptr || xPortInIsrContext()) return;
+  if (xTaskGetCurrentTaskHandle() != gesperrterTask) return;
+  // Kein Serial: das könnte selbst anfordern
+  esp_rom_printf("\n❌ HEAP_WAECHTER: %s(%u) im Abspiel-Task, Aufrufer %p\n", funktion,
+                 (unsigned)groesse, aufrufer);
+  abort();
+}
+
+extern "C" void* __wrap_malloc(size_t groesse) {
+  pruefeAnforderung("malloc", groesse, __builtin_return_address(0));
+  return __real_malloc(groesse);
+}
+
+extern "C" void* __wrap_calloc(size_t anzahl, size_t groesse) {
+  pruefeAnforderung("calloc", anzahl * groesse, __builtin_return_address(0));
+  return __real_calloc(anzahl, groesse);
+}
+
+extern "C" void* __wrap_realloc(void* zeiger, size_t groesse) {
+  pruefeAnforderung("realloc", groesse, __builtin_return_address(0));
+  return __real_realloc(zeiger, groesse);
+}
+
+void beginneHeapfreieZone() {
+  gesperrterTask = xTaskGetCurrentTaskHandle();
+}
+
+void beendeHeapfreieZone() {
+  gesperrterTask = nullptr;
+}
+
+bool heapWaechterAktiv() {
+  return true;
+}
+
+#else
+
+void beginneHeapfreieZone() {}
+void beendeHeapfreieZone() {}
+
+bool heapWaechterAktiv() {
+  return false;
+}
+
+#endif // HEAP_WAECHTER
@@ -0,0 +1,31 @@
+#ifndef HEAPWAECHTER_HPP
+#define HEAPWAECHTER_HPP
+
+#include <Arduino.h>
+
+// Zustand des Heaps und Prüfung, dass der Abspiel-Task im Dauerbetrieb nichts
+// anfordert (alle Puffer sind statisch, siehe Spannungswandlung.cpp).
+//   - holeHeapStatistik(): freier Speicher, größter Block, Fragmentierung (GET /heap)
+//   - Prüfbuild (env:heapwaechter, -D HEAP_WAECHTER, malloc/calloc/realloc per
+//     --wrap umgeleitet): jede Anforderung aus einer heapfreien Zone bricht mit
+//     Meldung ab. Ohne das Flag sind die Zonen leer und kosten nichts.
+
+struct HeapStatistik {
+  size_t frei = 0;              // internes RAM (8-Bit-fähig)
+  size_t groessterBlock = 0;
+  size_t minimumFrei = 0;       // Tiefststand seit dem Start
+  size_t belegteBloecke = 0;
+  size_t freieBloecke = 0;
+  float fragmentierung = 0.0f;  // 1 - größter Block / frei (0 = ein zusammenhängender Block)
+  size_t psramFrei = 0;
+  size_t psramGroessterBlock = 0;
+};
+
+HeapStatistik holeHeapStatistik();
+
+// Der aufrufende Task darf bis beendeHeapfreieZone() keinen Heap anfordern
+void beginneHeapfreieZone();
+void beendeHeapfreieZone();
+bool heapWaechterAktiv();     // mit HEAP_WAECHTER gebaut
+
+#endif // HEAPWAECHTER_HPP
@@ -0,0 +1,37 @@
+#include "Kalibrierung.hpp"
+#include <math.h>
+
+// Reine Berechnung ohne Arduino-Abhängigkeit (Host-Test: test/test_kalibrierung)
+
+static float interpoliereKorrektur(const KanalKalibrierung& k, int code) {
+  if (k.anzahlStuetzstellen == 0) return 0.0f;
+  if (code <= k.stuetzCode[0]) return k.korrektur[0];
+  const uint8_t letzte = k.anzahlStuetzstellen - 1;
+  if (code >= k.stuetzCode[letzte]) return k.korrektur[letzte];
+
+  uint8_t i = 1;
+  while (code > k.stuetzCode[i]) ++i;
+  float x0 = k.stuetzCode[i - 1], x1 = k.stuetzCode[i];
+  float y0 = k.korrektur[i - 1], y1 = k.korrektur[i];
+  return y0 + (y1 - y0) * ((float)code - x0) / (x1 - x0);
+}
+
+void baueKalibrierLut(const KanalKalibrierung& kalibrierung, uint16_t* lut) {
+  for (int code = 0; code < DAC_CODES; ++code) {
+    float wert = code * kalibrierung.gain + kalibrierung.offset + interpoliereKorrektur(kalibrierung, code);
+    long gerundet = lroundf(wert);
+    if (gerundet < 0) gerundet = 0;
+    if (gerundet > DAC_CODES - 1) gerundet = DAC_CODES - 1;
+    lut[code] = (uint16_t)gerundet;
+  }
+}
+
+bool kalibrierungGueltig(const KanalKalibrierung& kalibrierung) {
+  if (!(kalibrierung.gain > 0.0f) || !isfinite(kalibrierung.gain) || !isfinite(kalibrierung.offset)) return false;
+  if (kalibrierung.anzahlStuetzstellen > KALIBRIERUNG_STUETZSTELLEN) return false;
+  for (uint8_t i = 0; i < kalibrierung.anzahlStuetzstellen; ++i) {
+    if (kalibrierung.stuetzCode[i] >= DAC_CODES) return false;
+    if (i > 0 && kalibrierung.stuetzCode[i] <= kalibrierung.stuetzCode[i - 1]) return false;
+  }
+  return true;
+}
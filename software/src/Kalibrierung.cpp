@@ -0,0 +1,64 @@
+#include "Kalibrierung.hpp"
+#include "PinMapping.hpp"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_heap_caps.h>
+
+uint16_t* kalibrierLut[ANZAHL_KANAELE] = {};
+static KanalKalibrierung kalibrierungen[ANZAHL_KANAELE];
+
+static String nvsSchluessel(int kanal) {
+  return "k" + String(kanal);
+}
+
+static uint16_t* reserviereLut() {
+  const size_t groesse = DAC_CODES * sizeof(uint16_t);
+  void* lut = heap_caps_malloc(groesse, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (lut == nullptr) lut = heap_caps_malloc(groesse, MALLOC_CAP_SPIRAM);
+  return (uint16_t*)lut;
+}
+
+void ladeKalibrierung() {
+  for (int kanal = 0; kanal < ANZAHL_KANAELE; ++kanal) {
+    if (kalibrierLut[kanal] == nullptr) kalibrierLut[kanal] = reserviereLut();
+    if (kalibrierLut[kanal] == nullptr) {
+      Serial.println("❌ Kein Speicher für Kalibriertabellen");
+      while (true);
+    }
+  }
+
+  Preferences prefs;
+  prefs.begin("kalib", true);
+  for (int kanal = 0; kanal < ANZAHL_KANAELE; ++kanal) {
+    KanalKalibrierung k;
+    String key = nvsSchluessel(kanal);
+    if (prefs.getBytesLength(key.c_str()) == sizeof(k)) {
+      prefs.getBytes(key.c_str(), &k, sizeof(k));
+      if (!kalibrierungGueltig(k)) {
+        Serial.printf("⚠️ Kalibrierung Kanal %d ungültig, verwende Standardwerte\n", kanal);
+        k = KanalKalibrierung();
+      }
+    }
+    kalibrierungen[kanal] = k;
+    baueKalibrierLut(k, kalibrierLut[kanal]);
+  }
+  prefs.end();
+}
+
+bool setzeKalibrierung(int kanal, const KanalKalibrierung& kalibrierung) {
+  if (kanal < 0 || kanal >= ANZAHL_KANAELE || !kalibrierungGueltig(kalibrierung)) return false;
+
+  // Direkt in die Tabelle: der Aufrufer stellt sicher, dass keine Wiedergabe läuft
+  baueKalibrierLut(kalibrierung, kalibrierLut[kanal]);
+  kalibrierungen[kanal] = kalibrierung;
+
+  Preferences prefs;
+  prefs.begin("kalib", false);
+  size_t geschrieben = prefs.putBytes(nvsSchluessel(kanal).c_str(), &kalibrierung, sizeof(kalibrierung));
+  prefs.end();
+  return geschrieben == sizeof(kalibrierung);
+}
+
+const KanalKalibrierung& holeKalibrierung(int kanal) {
+  return kalibrierungen[kanal];
+}
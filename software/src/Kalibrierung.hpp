@@ -0,0 +1,38 @@
+#ifndef KALIBRIERUNG_HPP
+#define KALIBRIERUNG_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define DAC_CODES                 4096
+#define KALIBRIERUNG_STUETZSTELLEN 8
+
+// Kalibrierdaten eines Ausgangskanals (DAC + OPV-Tiefpass)
+//   code' = code * gain + offset + korrektur(code)
+// korrektur() interpoliert linear zwischen den Stützstellen (additiv, in DAC-Codes),
+// außerhalb der ersten/letzten Stützstelle wird der Randwert gehalten.
+struct KanalKalibrierung {
+  float gain = 1.0f;
+  float offset = 0.0f;                                   // in DAC-Codes
+  uint8_t anzahlStuetzstellen = 0;
+  uint16_t stuetzCode[KALIBRIERUNG_STUETZSTELLEN] = {};  // aufsteigend sortiert
+  int16_t korrektur[KALIBRIERUNG_STUETZSTELLEN] = {};    // in DAC-Codes
+};
+
+// Berechnet die 4096 Einträge der Korrekturtabelle eines Kanals
+void baueKalibrierLut(const KanalKalibrierung& kalibrierung, uint16_t* lut);
+
+// Prüft die Kalibrierdaten (Gain endlich und > 0, Stützstellen sortiert und im Wertebereich)
+bool kalibrierungGueltig(const KanalKalibrierung& kalibrierung);
+
+// Vorberechnete Tabellen pro Kanal; Zugriff im Abspiel-Task: lut[kanal][code]
+// (bevorzugt im internen RAM, bei vielen Kanälen im PSRAM)
+extern uint16_t* kalibrierLut[];
+
+void ladeKalibrierung();
+// Baut die Tabelle an Ort und Stelle neu und speichert im NVS. Der Abspiel-Task
+// liest die Tabellen ohne Sperre: nur unter KanalTabellenSperre aufrufen
+bool setzeKalibrierung(int kanal, const KanalKalibrierung& kalibrierung);
+const KanalKalibrierung& holeKalibrierung(int kanal);
+
+#endif // KALIBRIERUNG_HPP
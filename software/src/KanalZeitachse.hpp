@@ -0,0 +1,87 @@
+#ifndef KANALZEITACHSE_HPP
+#define KANALZEITACHSE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include "Festkomma.hpp"
+
+// Lage eines Kanals auf der gemeinsamen Zeitachse (Ausgabesamples im Quelltakt):
+// Kanalposition = (n - beginn) * schritt, schritt = Kanalrate / Quelltakt als
+// Ganzzahl plus 32 Bit Nachkommastellen. Die Samples werden beim Abspielen
+// abgetastet, nicht vorab auf den Ausgabetakt umgerechnet oder aufgefüllt.
+// Ohne Arduino-Abhängigkeit (Host-Test test/test_zeitachse).
+struct KanalZeitachse {
+  size_t beginn = 0;           // erstes Ausgabesample mit Daten (Startversatz)
+  uint32_t schrittGanz = 1;
+  uint32_t schrittBruch = 0;
+  bool direkt = true;          // gleicher Takt: Samples 1:1 übernehmen
+};
+
+// Phasenakkumulator: Kanalposition (ohne Schleifen-Modulo) mit Nachkommastellen
+struct KanalPhase {
+  uint32_t pos = 0;
+  uint32_t bruch = 0;
+
+  // Position für das n-te Ausgabesample ab Kanalbeginn, ohne 64-Bit-Überlauf
+  KanalPhase(const KanalZeitachse& za, size_t n) {
+    const uint64_t b = (uint64_t)n * za.schrittBruch;
+    pos = (uint32_t)n * za.schrittGanz + (uint32_t)(b >> 32);
+    bruch = (uint32_t)b;
+  }
+  void weiter(const KanalZeitachse& za) {
+    const uint64_t b = (uint64_t)bruch + za.schrittBruch;
+    bruch = (uint32_t)b;
+    pos += za.schrittGanz + (uint32_t)(b >> 32);
+  }
+};
+
+// Zeitachse eines Kanals mit eigener Rate (0 = Quelltakt) und Startversatz in s
+static inline KanalZeitachse berechneZeitachse(float abtastrateHz, float versatzS, float quellHz) {
+  KanalZeitachse za;
+  if (isfinite(versatzS) && versatzS > 0.0f) za.beginn = (size_t)lroundf(versatzS * quellHz);
+  if (isfinite(abtastrateHz) && abtastrateHz > 0.0f && abtastrateHz != quellHz) {
+    const uint64_t schritt = (uint64_t)((double)abtastrateHz / quellHz * 4294967296.0);
+    za.schrittGanz = (uint32_t)(schritt >> 32);
+    za.schrittBruch = (uint32_t)schritt;
+    za.direkt = false;
+  }
+  return za;
+}
+
+// Länge eines Kanals mit 'groesse' Samples in Ausgabesamples einschließlich Startversatz
+static inline size_t zeitachsenLaenge(size_t groesse, const KanalZeitachse& za) {
+  if (groesse == 0) return 0;
+  if (za.direkt) return za.beginn + groesse;
+  const uint64_t schritt = ((uint64_t)za.schrittGanz << 32) | za.schrittBruch;
+  if (schritt == 0) return za.beginn;
+  return za.beginn + (size_t)((((uint64_t)groesse << 32) + schritt - 1) / schritt);
+}
+
+// Linear interpoliertes Sample an der Phase; hinter dem Ende bei Schleife ab vorn
+static inline Q15 tasteAb(const Q15* samples, size_t groesse, bool schleife, uint32_t pos, uint32_t bruch) {
+  size_t naechste = pos + 1;
+  if (naechste >= groesse) naechste = schleife ? 0 : pos;
+  const int32_t a = samples[pos].roh;
+  const int32_t b = samples[naechste].roh;
+  // 15 Bit Anteil: (b - a) * anteil bleibt in 32 Bit
+  return Q15::ausRoh((int16_t)(a + (((b - a) * (int32_t)(bruch >> 17)) >> 15)));
+}
+
+// Tastet 'anzahl' Werte ab dem n-ten Ausgabesample ab Kanalbeginn ab; liefert,
+// wie viele vor dem Kanalende lagen (bei Schleife alle)
+static inline size_t tasteBlockAb(const Q15* samples, size_t groesse, bool schleife, const KanalZeitachse& za,
+                                  size_t n, size_t anzahl, Q15* ziel) {
+  if (groesse == 0) return 0;
+  KanalPhase phase(za, n);
+  for (size_t j = 0; j < anzahl; ++j) {
+    uint32_t pos = phase.pos;
+    if (schleife) pos %= groesse;
+    else if (pos >= groesse) return j;
+    ziel[j] = tasteAb(samples, groesse, schleife, pos, phase.bruch);
+    phase.weiter(za);
+  }
+  return anzahl;
+}
+
+#endif // KANALZEITACHSE_HPP
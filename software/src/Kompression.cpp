@@ -0,0 +1,278 @@
+#include "Kompression.hpp"
+#include <string.h>
+#include <math.h>
+
+// Ab diesem Quotienten wird der Wert unkodiert (32 Bit) abgelegt
+#define RICE_ESCAPE     24
+#define RICE_K_MAX      30
+// Begrenzung der quantisierten Werte, damit Vorhersage und Residuum in 32 Bit passen
+#define SAMPLE_GRENZE   ((int32_t)0x0FFFFFFF)
+
+static inline int32_t quantisiere(float wert, uint32_t teiler) {
+  double q = round((double)wert * teiler);
+  if (q > SAMPLE_GRENZE) q = SAMPLE_GRENZE;
+  if (q < -SAMPLE_GRENZE) q = -SAMPLE_GRENZE;
+  return (int32_t)q;
+}
+
+static inline uint32_t zigzag(int32_t r) {
+  return ((uint32_t)r << 1) ^ (uint32_t)(r >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t u) {
+  return (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+}
+
+static inline uint32_t riceKosten(uint32_t u, uint8_t k) {
+  uint32_t q = u >> k;
+  return (q < RICE_ESCAPE) ? q + 1 + k : RICE_ESCAPE + 32;
+}
+
+// Bitweises Schreiben, MSB zuerst
+struct BitSchreiber {
+  std::vector<uint8_t>& ziel;
+  uint64_t puffer = 0;
+  uint8_t bits = 0;
+
+  explicit BitSchreiber(std::vector<uint8_t>& z) : ziel(z) {}
+
+  void schreibe(uint32_t wert, uint8_t anzahl) {
+    if (anzahl == 0) return;
+    puffer = (puffer << anzahl) | (wert & (uint32_t)((1ULL << anzahl) - 1));
+    bits += anzahl;
+    while (bits >= 8) {
+      bits -= 8;
+      ziel.push_back((uint8_t)(puffer >> bits));
+    }
+  }
+
+  void einsen(uint32_t anzahl) {
+    while (anzahl >= 16) { schreibe(0xFFFF, 16); anzahl -= 16; }
+    schreibe((1UL << anzahl) - 1, anzahl);
+  }
+
+  void abschliessen() {
+    if (bits > 0) ziel.push_back((uint8_t)(puffer << (8 - bits)));
+    bits = 0;
+  }
+};
+
+// Bitweises Lesen mit 64-Bit-Cache (linksbündig), MSB zuerst
+struct BitLeser {
+  const uint8_t* daten;
+  size_t laenge;
+  size_t pos = 0;
+  uint64_t cache = 0;
+  uint8_t bits = 0;
+
+  BitLeser(const uint8_t* d, size_t l) : daten(d), laenge(l) {}
+
+  inline void auffuellen() {
+    while (bits <= 56) {
+      uint64_t b = (pos < laenge) ? daten[pos] : 0;  // Über das Ende hinaus mit Nullen auffüllen
+      pos++;
+      cache |= b << (56 - bits);
+      bits += 8;
+    }
+  }
+
+  inline uint32_t lese(uint8_t anzahl) {
+    if (anzahl == 0) return 0;
+    uint32_t wert = (uint32_t)(cache >> (64 - anzahl));
+    cache <<= anzahl;
+    bits -= anzahl;
+    return wert;
+  }
+
+  // Zählt führende Einsen (max. RICE_ESCAPE) und verbraucht sie samt Stoppbit
+  inline uint32_t unaer() {
+    uint64_t invers = ~cache;
+    uint32_t einsen = invers ? __builtin_clzll(invers) : 64;
+    if (einsen >= RICE_ESCAPE) {
+      cache <<= RICE_ESCAPE;
+      bits -= RICE_ESCAPE;
+      return RICE_ESCAPE;
+    }
+    cache <<= (einsen + 1);
+    bits -= (einsen + 1);
+    return einsen;
+  }
+
+  bool ueberlauf() const {
+    // pos zählt bereits gelesene, aber noch nicht verbrauchte Bytes mit
+    return (pos - bits / 8) > laenge;
+  }
+};
+
+static inline bool liegtAufStufe(float wert, uint32_t teiler) {
+  double skaliert = (double)wert * teiler;
+  return fabs(skaliert - round(skaliert)) <= 1e-3 + fabs(skaliert) * 1e-6;
+}
+
+// Gröbste Quantisierung (1, 10, 100 oder 1000 Schritte pro mV), die alle Werte exakt abbildet.
+// Textdateien mit zwei Nachkommastellen brauchen so keine Bits für die ungenutzte dritte Stelle.
+// 'exakt' wird false, wenn ein Wert auch auf 1 µV nicht aufgeht (er wird dann gerundet).
+static uint32_t bestimmeTeiler(const float* samples, size_t anzahl, bool& exakt) {
+  uint32_t teiler = 1;
+  exakt = true;
+  for (size_t i = 0; i < anzahl; ++i) {
+    while (teiler < KOMPRESSION_TEILER_PRO_MV && !liegtAufStufe(samples[i], teiler)) teiler *= 10;
+    if (teiler == KOMPRESSION_TEILER_PRO_MV && !liegtAufStufe(samples[i], teiler)) {
+      exakt = false;
+      break;
+    }
+  }
+  return teiler;
+}
+
+static void kodiereBlock(const int32_t* q, size_t n, std::vector<uint8_t>& ausgabe) {
+  // Residuen der Vorhersage zweiter Ordnung bestimmen
+  std::vector<uint32_t> residuen;
+  residuen.reserve(n > 2 ? n - 2 : 0);
+  for (size_t i = 2; i < n; ++i) {
+    int32_t vorhersage = 2 * q[i - 1] - q[i - 2];
+    residuen.push_back(zigzag(q[i] - vorhersage));
+  }
+
+  // Rice-Parameter mit den geringsten Gesamtkosten wählen
+  uint8_t bestesK = 0;
+  uint64_t besteKosten = UINT64_MAX;
+  for (uint8_t k = 0; k <= RICE_K_MAX; ++k) {
+    uint64_t kosten = 0;
+    for (uint32_t u : residuen) kosten += riceKosten(u, k);
+    if (kosten < besteKosten) {
+      besteKosten = kosten;
+      bestesK = k;
+    }
+  }
+
+  size_t headerPos = ausgabe.size();
+  ausgabe.resize(headerPos + sizeof(BlockHeader));
+
+  BitSchreiber schreiber(ausgabe);
+  for (uint32_t u : residuen) {
+    uint32_t quotient = u >> bestesK;
+    if (quotient >= RICE_ESCAPE) {
+      schreiber.einsen(RICE_ESCAPE);
+      schreiber.schreibe(u, 32);
+    } else {
+      schreiber.einsen(quotient);
+      schreiber.schreibe(0, 1);
+      schreiber.schreibe(u, bestesK);
+    }
+  }
+  schreiber.abschliessen();
+
+  BlockHeader header;
+  header.start0 = q[0];
+  header.start1 = (n > 1) ? q[1] : 0;
+  header.riceK = bestesK;
+  header.reserviert = 0;
+  header.nutzdatenBytes = (uint16_t)(ausgabe.size() - headerPos - sizeof(BlockHeader));
+  memcpy(&ausgabe[headerPos], &header, sizeof(header));
+}
+
+bool kodiereSamples(const float* samples, size_t anzahl, std::vector<uint8_t>& ausgabe, uint16_t blockGroesse) {
+  if (blockGroesse < 2) blockGroesse = 2;
+  // Nutzdaten müssen in 16 Bit passen: Worst Case 56 Bit pro Sample
+  if (blockGroesse > 1024) blockGroesse = 1024;
+
+  KompressionsHeader header;
+  header.magic = KOMPRESSION_MAGIC;
+  header.version = KOMPRESSION_VERSION;
+  header.blockGroesse = blockGroesse;
+  header.sampleAnzahl = (uint32_t)anzahl;
+  header.blockAnzahl = (uint32_t)((anzahl + blockGroesse - 1) / blockGroesse);
+  bool exakt = true;
+  header.teilerProMv = bestimmeTeiler(samples, anzahl, exakt);
+
+  ausgabe.clear();
+  ausgabe.resize(sizeof(header) + header.blockAnzahl * sizeof(uint32_t));
+  memcpy(ausgabe.data(), &header, sizeof(header));
+
+  const size_t datenStart = ausgabe.size();
+  std::vector<int32_t> q(blockGroesse);
+
+  for (uint32_t b = 0; b < header.blockAnzahl; ++b) {
+    size_t beginn = (size_t)b * blockGroesse;
+    size_t n = anzahl - beginn;
+    if (n > blockGroesse) n = blockGroesse;
+    for (size_t i = 0; i < n; ++i) {
+      q[i] = quantisiere(samples[beginn + i], header.teilerProMv);
+      if (q[i] == SAMPLE_GRENZE || q[i] == -SAMPLE_GRENZE) exakt = false;   // begrenzt
+    }
+
+    uint32_t offset = (uint32_t)(ausgabe.size() - datenStart);
+    memcpy(&ausgabe[sizeof(header) + b * sizeof(uint32_t)], &offset, sizeof(offset));
+    kodiereBlock(q.data(), n, ausgabe);
+  }
+  return exakt;
+}
+
+bool pruefeKompressionsHeader(const uint8_t* daten, size_t laenge, KompressionsHeader& header) {
+  if (laenge < sizeof(KompressionsHeader)) return false;
+  memcpy(&header, daten, sizeof(header));
+  if (header.magic != KOMPRESSION_MAGIC || header.version != KOMPRESSION_VERSION) return false;
+  if (header.blockGroesse < 2 || header.teilerProMv == 0) return false;
+  if (header.blockAnzahl != (header.sampleAnzahl + header.blockGroesse - 1) / header.blockGroesse) return false;
+  return true;
+}
+
+size_t dekodiereBlock(const uint8_t* block, size_t laenge, size_t sampleAnzahl, int32_t* ausgabe) {
+  if (laenge < sizeof(BlockHeader) || sampleAnzahl == 0) return 0;
+  BlockHeader header;
+  memcpy(&header, block, sizeof(header));
+  if (header.riceK > RICE_K_MAX || sizeof(BlockHeader) + header.nutzdatenBytes > laenge) return 0;
+
+  ausgabe[0] = header.start0;
+  if (sampleAnzahl == 1) return 1;
+  ausgabe[1] = header.start1;
+
+  BitLeser leser(block + sizeof(BlockHeader), header.nutzdatenBytes);
+  const uint8_t k = header.riceK;
+  int32_t x1 = header.start1;
+  int32_t x2 = header.start0;
+
+  for (size_t i = 2; i < sampleAnzahl; ++i) {
+    leser.auffuellen();
+    uint32_t quotient = leser.unaer();
+    uint32_t u;
+    if (quotient == RICE_ESCAPE) {
+      u = leser.lese(32);
+    } else {
+      u = (quotient << k) | leser.lese(k);
+    }
+    int32_t x = 2 * x1 - x2 + unzigzag(u);
+    ausgabe[i] = x;
+    x2 = x1;
+    x1 = x;
+  }
+  return leser.ueberlauf() ? 0 : sampleAnzahl;
+}
+
+bool dekodiereSamples(const uint8_t* daten, size_t laenge, std::vector<float>& ausgabe) {
+  KompressionsHeader header;
+  if (!pruefeKompressionsHeader(daten, laenge, header)) return false;
+
+  const size_t tabelleEnde = sizeof(header) + (size_t)header.blockAnzahl * sizeof(uint32_t);
+  if (laenge < tabelleEnde) return false;
+  const uint32_t* offsets = reinterpret_cast<const uint32_t*>(daten + sizeof(header));
+
+  ausgabe.resize(header.sampleAnzahl);
+  std::vector<int32_t> q(header.blockGroesse);
+  const double teiler = (double)header.teilerProMv;
+
+  for (uint32_t b = 0; b < header.blockAnzahl; ++b) {
+    uint32_t offset;
+    memcpy(&offset, &offsets[b], sizeof(offset));
+    if (tabelleEnde + offset >= laenge) return false;
+
+    size_t beginn = (size_t)b * header.blockGroesse;
+    size_t n = header.sampleAnzahl - beginn;
+    if (n > header.blockGroesse) n = header.blockGroesse;
+
+    if (dekodiereBlock(daten + tabelleEnde + offset, laenge - tabelleEnde - offset, n, q.data()) != n) return false;
+    for (size_t i = 0; i < n; ++i) ausgabe[beginn + i] = (float)(q[i] / teiler);
+  }
+  return true;
+}
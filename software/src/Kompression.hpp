@@ -0,0 +1,60 @@
+#ifndef KOMPRESSION_HPP
+#define KOMPRESSION_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Blockbasiertes Speicherformat für EEG-Samples (.eegz), verlustfrei bis 1 µV
+//
+// Aufbau der Datei (Little Endian):
+//   KompressionsHeader
+//   uint32_t blockOffset[blockAnzahl]   (relativ zum Beginn der Blockdaten)
+//   Blöcke: BlockHeader + Rice-kodierte Residuen
+//
+// Die Samples werden in Schritten von 1/teilerProMv mV quantisiert (gröbste
+// Stufe, die alle Werte exakt abbildet, höchstens 1 µV), pro Block mit einer Vorhersage zweiter Ordnung
+// (2*x[n-1] - x[n-2]) geschätzt und das Residuum Rice-kodiert.
+// Exakt sind damit Werte mit bis zu drei Nachkommastellen (in mV) und Betrag
+// unter 268 V; feinere Stellen werden auf 1 µV gerundet, das meldet
+// kodiereSamples() mit false.
+// Über die Offset-Tabelle kann jeder Block direkt angesprungen werden.
+
+#define KOMPRESSION_MAGIC          0x5A474545UL  // "EEGZ"
+#define KOMPRESSION_VERSION        1
+#define KOMPRESSION_BLOCKGROESSE   256
+#define KOMPRESSION_TEILER_PRO_MV  1000          // feinste Stufe: 1 LSB = 1 µV
+
+struct __attribute__((packed)) KompressionsHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t blockGroesse;     // Samples pro Block
+  uint32_t sampleAnzahl;
+  uint32_t blockAnzahl;
+  uint32_t teilerProMv;      // Quantisierung: Wert[mV] = Sample / teilerProMv
+};
+
+struct __attribute__((packed)) BlockHeader {
+  int32_t  start0;           // erste beiden Samples unkodiert
+  int32_t  start1;
+  uint8_t  riceK;            // Rice-Parameter des Blocks
+  uint8_t  reserviert;
+  uint16_t nutzdatenBytes;   // Länge der Residuen in Bytes
+};
+
+// Kodiert die Samples (mV) in das .eegz-Format; false, wenn dabei Werte auf
+// 1 µV gerundet oder begrenzt wurden (die Datei ist trotzdem gültig)
+bool kodiereSamples(const float* samples, size_t anzahl, std::vector<uint8_t>& ausgabe,
+                    uint16_t blockGroesse = KOMPRESSION_BLOCKGROESSE);
+
+// Prüft Magic, Version und Mindestlänge und liest den Header aus
+bool pruefeKompressionsHeader(const uint8_t* daten, size_t laenge, KompressionsHeader& header);
+
+// Dekodiert einen einzelnen Block (BlockHeader + Nutzdaten) in quantisierte Samples.
+// Gibt die Anzahl der dekodierten Samples zurück (0 bei Fehler).
+size_t dekodiereBlock(const uint8_t* block, size_t laenge, size_t sampleAnzahl, int32_t* ausgabe);
+
+// Dekodiert eine vollständige .eegz-Datei aus dem Speicher in mV-Werte
+bool dekodiereSamples(const uint8_t* daten, size_t laenge, std::vector<float>& ausgabe);
+
+#endif // KOMPRESSION_HPP
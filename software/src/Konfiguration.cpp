@@ -0,0 +1,185 @@
+#include "Konfiguration.hpp"
+#include "Spannungswandlung.hpp"
+#include <Preferences.h>
+#include <SPIFFS.h>
+#include <atomic>
+
+// Zwei Fassungen: Leser sehen immer eine vollständige, Schreiber füllen die andere
+static Konfiguration fassung[2];
+static std::atomic<const Konfiguration*> aktuell{&fassung[0]};
+static SemaphoreHandle_t schreibSperre = nullptr;
+
+static volatile bool ausstehend = false;
+static volatile uint32_t letzteAenderungMs = 0;
+
+Konfiguration::Konfiguration() {
+  for (uint8_t i = 0; i < ANZAHL_KANAELE; ++i) kanalZuordnung[i] = i;
+}
+
+void ladeKonfiguration() {
+  if (schreibSperre == nullptr) schreibSperre = xSemaphoreCreateMutex();
+
+  Konfiguration k;
+  Preferences prefs;
+  prefs.begin("konfig", true);
+  // "freq" (ganze Hz) stammt aus einer früheren Fassung
+  k.frequenzHz = prefs.getFloat("frequenz", prefs.getUShort("freq", (uint16_t)k.frequenzHz));
+  k.bereichsModus = (BereichsModus)prefs.getUChar("bmodus", (uint8_t)k.bereichsModus);
+  k.minMv = prefs.getFloat("bmin", k.minMv);
+  k.maxMv = prefs.getFloat("bmax", k.maxMv);
+  k.autostart = prefs.getBool("autostart", k.autostart);
+  k.abspielPrio = prefs.getUChar("prioAbspiel", k.abspielPrio);
+  k.vorladePrio = prefs.getUChar("prioVorlade", k.vorladePrio);
+  // Nach Änderung von DAC_ANZAHL passt die Länge nicht mehr: Standard behalten
+  if (prefs.getBytesLength("zuordnung") == sizeof(k.kanalZuordnung)) {
+    prefs.getBytes("zuordnung", k.kanalZuordnung, sizeof(k.kanalZuordnung));
+  }
+  const bool syncGespeichert = prefs.isKey("sync");
+  k.syncModus = (SyncModus)prefs.getUChar("sync", (uint8_t)k.syncModus);
+  const bool triggerGespeichert = prefs.isKey("tAktion");
+  k.trigger.aktion = (TriggerAktion)prefs.getUChar("tAktion", (uint8_t)k.trigger.aktion);
+  k.trigger.flanke = (TriggerFlanke)prefs.getUChar("tFlanke", (uint8_t)k.trigger.flanke);
+  k.trigger.entprellUs = prefs.getULong("tEntprell", k.trigger.entprellUs);
+  prefs.end();
+
+  // Sync und Trigger lagen früher in eigenen Namensräumen
+  if (!syncGespeichert && prefs.begin("sync", true)) {
+    k.syncModus = (SyncModus)prefs.getUChar("modus", (uint8_t)k.syncModus);
+    prefs.end();
+  }
+  if (!triggerGespeichert && prefs.begin("trigger", true)) {
+    k.trigger.aktion = (TriggerAktion)prefs.getUChar("aktion", (uint8_t)k.trigger.aktion);
+    k.trigger.flanke = (TriggerFlanke)prefs.getUChar("flanke", (uint8_t)k.trigger.flanke);
+    k.trigger.entprellUs = prefs.getULong("entprell", k.trigger.entprellUs);
+    prefs.end();
+  }
+
+  String fehler;
+  if (!konfigurationGueltig(k, fehler)) {
+    Serial.println("⚠️ Konfiguration ungültig (" + fehler + "), verwende Standardwerte");
+    k = Konfiguration();
+  }
+  fassung[0] = k;
+  aktuell.store(&fassung[0], std::memory_order_release);
+}
+
+const Konfiguration& konfiguration() {
+  return *aktuell.load(std::memory_order_acquire);
+}
+
+bool konfigurationGueltig(const Konfiguration& k, String& fehler) {
+  if (!(k.frequenzHz >= 1.0f && k.frequenzHz <= 1000.0f)) {
+    fehler = "frequency: 1..1000 Hz";
+    return false;
+  }
+  if (!ausgabetaktGueltig(k.frequenzHz, filterEinstellung, fehler)) return false;
+  if ((uint8_t)k.bereichsModus > (uint8_t)BereichsModus::BENUTZER || !isfinite(k.minMv) ||
+      !isfinite(k.maxMv) || k.minMv >= k.maxMv) {
+    fehler = "range: min < max";
+    return false;
+  }
+  // Über loop() (1), unter den Systemtasks
+  if (k.abspielPrio < 2 || k.abspielPrio >= configMAX_PRIORITIES - 1 ||
+      k.vorladePrio < 1 || k.vorladePrio >= configMAX_PRIORITIES - 1) {
+    fehler = "priority: außerhalb des zulässigen Bereichs";
+    return false;
+  }
+  bool belegt[ANZAHL_KANAELE] = {};
+  for (uint8_t i = 0; i < ANZAHL_KANAELE; ++i) {
+    uint8_t ziel = k.kanalZuordnung[i];
+    if (ziel >= ANZAHL_KANAELE || belegt[ziel]) {
+      fehler = "channelMap: jeder Ausgang genau einmal";
+      return false;
+    }
+    belegt[ziel] = true;
+  }
+  if ((uint8_t)k.syncModus > (uint8_t)SyncModus::SLAVE) {
+    fehler = "sync: master, slave oder off";
+    return false;
+  }
+  if ((uint8_t)k.trigger.aktion > (uint8_t)TriggerAktion::WEITER ||
+      (uint8_t)k.trigger.flanke > (uint8_t)TriggerFlanke::BEIDE || k.trigger.entprellUs > TRIGGER_MAX_ENTPRELL_US) {
+    fehler = "trigger: unbekannte Aktion/Flanke oder Entprellzeit zu lang";
+    return false;
+  }
+  return true;
+}
+
+bool ausgabetaktGueltig(float frequenzHz, const FilterEinstellung& filter, String& fehler) {
+  const FilterEinstellung e = begrenzeFilterEinstellung(filter);
+  const float taktHz = frequenzHz * (e.aktiv() ? e.faktor : 1);
+  const float maxHz = maxAusgabetaktHz(e, ANZAHL_KANAELE);
+  if (taktHz > maxHz) {
+    fehler = "frequency: Ausgabetakt " + String(taktHz, 0) + " Hz über dem Zeitbudget (max. " +
+             String(maxHz, 0) + " Hz bei " + String(ANZAHL_KANAELE) + " Kanälen)";
+    return false;
+  }
+  return true;
+}
+
+bool aendereKonfiguration(const Konfiguration& neu, String& fehler) {
+  if (!konfigurationGueltig(neu, fehler)) return false;
+  xSemaphoreTake(schreibSperre, portMAX_DELAY);
+  Konfiguration* frei = (aktuell.load() == &fassung[0]) ? &fassung[1] : &fassung[0];
+  *frei = neu;
+  aktuell.store(frei, std::memory_order_release);
+  letzteAenderungMs = millis();
+  ausstehend = true;
+  xSemaphoreGive(schreibSperre);
+  return true;
+}
+
+static void schreibeNvs(const Konfiguration& k) {
+  Preferences prefs;
+  prefs.begin("konfig", false);
+  prefs.putFloat("frequenz", k.frequenzHz);
+  if (prefs.isKey("freq")) prefs.remove("freq");
+  prefs.putUChar("bmodus", (uint8_t)k.bereichsModus);
+  prefs.putFloat("bmin", k.minMv);
+  prefs.putFloat("bmax", k.maxMv);
+  prefs.putBool("autostart", k.autostart);
+  prefs.putUChar("prioAbspiel", k.abspielPrio);
+  prefs.putUChar("prioVorlade", k.vorladePrio);
+  prefs.putBytes("zuordnung", k.kanalZuordnung, sizeof(k.kanalZuordnung));
+  prefs.putUChar("sync", (uint8_t)k.syncModus);
+  prefs.putUChar("tAktion", (uint8_t)k.trigger.aktion);
+  prefs.putUChar("tFlanke", (uint8_t)k.trigger.flanke);
+  prefs.putULong("tEntprell", k.trigger.entprellUs);
+  prefs.end();
+}
+
+bool konfigurationAusstehend() {
+  return ausstehend;
+}
+
+void speichereKonfigurationJetzt() {
+  if (!ausstehend) return;
+  xSemaphoreTake(schreibSperre, portMAX_DELAY);
+  Konfiguration kopie = konfiguration();
+  ausstehend = false;
+  xSemaphoreGive(schreibSperre);
+  schreibeNvs(kopie);
+  Serial.println("💾 Konfiguration gespeichert");
+}
+
+void bearbeiteKonfiguration() {
+  if (ausstehend && millis() - letzteAenderungMs >= KONFIG_SPEICHER_VERZOEGERUNG_MS) {
+    speichereKonfigurationJetzt();
+  }
+}
+
+void uebernehmeFrequenzdatei() {
+  File f = SPIFFS.open("/freq.cfg", "r");
+  if (!f) return;
+  float hz = f.readStringUntil('\n').toFloat();
+  f.close();
+  SPIFFS.remove("/freq.cfg");
+
+  Konfiguration k = konfiguration();
+  k.frequenzHz = hz;
+  String fehler;
+  if (aendereKonfiguration(k, fehler)) {
+    speichereKonfigurationJetzt();
+    Serial.printf("Frequenz %.1f Hz aus /freq.cfg in die Konfiguration übernommen\n", hz);
+  }
+}
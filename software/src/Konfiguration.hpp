@@ -0,0 +1,65 @@
+#ifndef KONFIGURATION_HPP
+#define KONFIGURATION_HPP
+
+#include <Arduino.h>
+#include "PinMapping.hpp"
+#include "Skalierung.hpp"
+#include "TaskTopologie.hpp"
+#include "Rekonstruktion.hpp"
+#include "Synchronisation.hpp"
+#include "Trigger.hpp"
+
+// Gerätekonfiguration im NVS (Namensraum "konfig", ein typisierter Schlüssel
+// pro Feld) mit einer Kopie im RAM.
+//   - Lesen: konfiguration() ohne Sperre, auch aus dem Abspiel-Task; die
+//     benötigten Felder sofort kopieren, nicht die Referenz aufheben
+//   - Ändern: aendereKonfiguration() prüft, veröffentlicht die neue Fassung
+//     und schreibt sie erst nach KONFIG_SPEICHER_VERZOEGERUNG_MS ohne weitere
+//     Änderung ins NVS (mehrere Änderungen = ein Schreibvorgang)
+// Die Kalibrierung bleibt wegen ihrer Tabellen in Kalibrierung.hpp. Sync-Modus
+// und Trigger übernehmen Synchronisation bzw. Trigger beim Start; nach einer
+// Änderung wendet der Aufrufer sie mit setzeSyncModus()/setzeTriggerEinstellung() an.
+
+#define KONFIG_SPEICHER_VERZOEGERUNG_MS  2000
+
+struct Konfiguration {
+  float frequenzHz = 100.0f;                        // Ausgabefrequenz 1..1000 Hz, auch gebrochen
+  // Amplitudenbereich für Kanäle ohne Angabe in /processFiles
+  BereichsModus bereichsModus = BereichsModus::FEST;
+  float minMv = STANDARD_MIN_MV;
+  float maxMv = STANDARD_MAX_MV;
+  bool autostart = false;                           // siehe Wiedergabebild.hpp
+  // Task-Prioritäten, wirksam ab dem nächsten Start
+  uint8_t abspielPrio = ABSPIEL_TASK_PRIO;
+  uint8_t vorladePrio = VORLADE_TASK_PRIO;
+  // Datenkanal -> DAC-Ausgang (Permutation, Standard: identisch)
+  uint8_t kanalZuordnung[ANZAHL_KANAELE];
+  SyncModus syncModus = SyncModus::AUS;             // nur ohne laufende Wiedergabe ändern
+  TriggerEinstellung trigger;
+
+  Konfiguration();
+};
+
+// Einmalig in setup(), vor allen Lesern
+void ladeKonfiguration();
+
+// Aktuelle Fassung (sperrfrei)
+const Konfiguration& konfiguration();
+
+// false, wenn ein Feld ungültig ist (fehler beschreibt es)
+bool konfigurationGueltig(const Konfiguration& k, String& fehler);
+bool aendereKonfiguration(const Konfiguration& neu, String& fehler);
+// Ausgabetakt (frequenzHz * Überabtastung) im Zeitbudget aller Kanäle;
+// gemeinsame Prüfung für /config, /setFrequency und /filter
+bool ausgabetaktGueltig(float frequenzHz, const FilterEinstellung& filter, String& fehler);
+
+// Aus loop(): schreibt eine ausstehende Änderung nach Ablauf der Verzögerung
+void bearbeiteKonfiguration();
+bool konfigurationAusstehend();   // Änderung noch nicht im NVS
+// Schreibt eine ausstehende Änderung sofort (z. B. vor einem Neustart)
+void speichereKonfigurationJetzt();
+
+// Übernimmt einmalig eine alte /freq.cfg aus dem SPIFFS und löscht sie
+void uebernehmeFrequenzdatei();
+
+#endif // KONFIGURATION_HPP
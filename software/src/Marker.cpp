@@ -0,0 +1,106 @@
+#include "Marker.hpp"
+#include <SPIFFS.h>
+#include <algorithm>
+
+static MarkerEreignis protokoll[MARKER_LOG_GROESSE];
+static size_t protokollPos = 0;
+static MarkerStatistik statistik;
+static portMUX_TYPE protokollSperre = portMUX_INITIALIZER_UNLOCKED;
+
+String markerPfad(const String& textPfad) {
+  String basis = textPfad;
+  if (basis.endsWith(".txt")) basis = basis.substring(0, basis.length() - 4);
+  return basis + MARKER_ENDUNG;
+}
+
+// Zeitangabe oder Samplenummer am Zeilenanfang; liefert die Position nach der Zahl
+static bool leseZeitpunkt(const String& zeile, Marker& m, int& ende) {
+  const char* anfang = zeile.c_str();
+  char* rest = nullptr;
+  bool sekunden = false;
+  if (*anfang == '+') {
+    // EDF+-TAL: Onset in Sekunden
+    anfang++;
+    sekunden = true;
+  }
+  double wert = strtod(anfang, &rest);
+  if (rest == anfang || wert < 0.0) return false;
+  if (*rest == 's') {
+    sekunden = true;
+    rest++;
+  }
+  if (sekunden) {
+    m.zeitS = (float)wert;
+  } else {
+    m.nummer = (uint32_t)(wert + 0.5);
+  }
+  ende = rest - zeile.c_str();
+  return true;
+}
+
+bool ladeMarkerDatei(const String& pfad, std::vector<Marker>& marker) {
+  marker.clear();
+  if (!SPIFFS.exists(pfad)) return false;
+  File file = SPIFFS.open(pfad, "r");
+  if (!file) return false;
+
+  while (file.available()) {
+    String zeile = file.readStringUntil('\n');
+    zeile.trim();
+    if (zeile.length() == 0 || zeile[0] == '#') continue;
+
+    Marker m;
+    int ende = 0;
+    if (!leseZeitpunkt(zeile, m, ende)) continue;
+
+    // Text: Rest der Zeile ohne TAL-Trennzeichen (0x14/0x15) und Dauerangabe
+    String text = zeile.substring(ende);
+    int tal = text.lastIndexOf((char)0x14, text.length() >= 2 ? text.length() - 2 : 0);
+    if (tal >= 0) text = text.substring(tal + 1);
+    text.replace(String((char)0x14), "");
+    text.trim();
+    strncpy(m.text, text.c_str(), MARKER_TEXT_LAENGE - 1);
+    marker.push_back(m);
+  }
+  file.close();
+  return true;
+}
+
+void setzeMarkerRate(std::vector<Marker>& marker, float abtastrateHz) {
+  for (Marker& m : marker) {
+    const uint32_t inDatei = (m.zeitS >= 0.0f) ? (uint32_t)(m.zeitS * abtastrateHz + 0.5f) : m.nummer;
+    m.sample = m.versatz + inDatei;
+  }
+  std::stable_sort(marker.begin(), marker.end(),
+                   [](const Marker& a, const Marker& b) { return a.sample < b.sample; });
+}
+
+void loescheMarkerProtokoll() {
+  portENTER_CRITICAL(&protokollSperre);
+  protokollPos = 0;
+  statistik = MarkerStatistik();
+  portEXIT_CRITICAL(&protokollSperre);
+}
+
+void protokolliereMarker(const MarkerEreignis& ereignis) {
+  portENTER_CRITICAL(&protokollSperre);
+  protokoll[protokollPos % MARKER_LOG_GROESSE] = ereignis;
+  protokollPos++;
+  statistik.anzahl++;
+  statistik.summeLatenzNs += ereignis.latenzNs;
+  if (ereignis.latenzNs > statistik.maxLatenzNs) statistik.maxLatenzNs = ereignis.latenzNs;
+  portEXIT_CRITICAL(&protokollSperre);
+}
+
+size_t leseMarkerProtokoll(MarkerEreignis* ziel, size_t maxAnzahl, MarkerStatistik& stat) {
+  portENTER_CRITICAL(&protokollSperre);
+  size_t vorhanden = protokollPos < MARKER_LOG_GROESSE ? protokollPos : MARKER_LOG_GROESSE;
+  size_t anzahl = vorhanden < maxAnzahl ? vorhanden : maxAnzahl;
+  // Älteste zuerst
+  for (size_t i = 0; i < anzahl; ++i) {
+    ziel[i] = protokoll[(protokollPos - anzahl + i) % MARKER_LOG_GROESSE];
+  }
+  stat = statistik;
+  portEXIT_CRITICAL(&protokollSperre);
+  return anzahl;
+}
@@ -0,0 +1,63 @@
+#ifndef MARKER_HPP
+#define MARKER_HPP
+
+#include <Arduino.h>
+#include <vector>
+
+// Trigger-Marker: Ereignisse im Signal heben den Marker-Ausgang (MARKER_PIN)
+// im selben Frame wie die zugehörige DAC-Übernahme für ein Quellsample an;
+// mit Rekonstruktionsfilter erst, wenn das gefilterte Sample erscheint
+// (Gruppenlaufzeit, siehe gruppenlaufzeit() in Rekonstruktion.hpp).
+//
+// Marker stehen in einer Begleitdatei zur Signaldatei ("/x.txt" -> "/x.mrk"),
+// eine Zeile pro Ereignis:
+//   1250 Stim          Samplenummer (ab 0) und Text
+//   2.5s Stim          Zeitpunkt in Sekunden
+//   +2.5<0x14>Stim     EDF+-Annotation (TAL) mit Onset in Sekunden
+// Leerzeilen und Zeilen mit '#' werden ignoriert.
+
+#define MARKER_ENDUNG        ".mrk"
+#define MARKER_TEXT_LAENGE   16
+#define MARKER_LOG_GROESSE   64
+
+// Zeitangaben in Sekunden werden erst beim Armieren mit der dann gültigen
+// Abtastrate in Samplenummern umgerechnet (setzeMarkerRate())
+struct Marker {
+  uint32_t sample = 0;        // Sample im Kanal, gültig nach setzeMarkerRate()
+  uint32_t versatz = 0;       // Samples vor der Datei (mehrere Dateien pro Kanal)
+  uint32_t nummer = 0;        // Samplenummer in der Datei
+  float zeitS = -1.0f;        // oder Zeitpunkt in s ab Dateibeginn (>= 0)
+  char text[MARKER_TEXT_LAENGE] = {};
+};
+
+// Protokolleintrag eines ausgegebenen Markers
+struct MarkerEreignis {
+  uint32_t sample = 0;       // Quellsample seit Abspielstart
+  int64_t zeitUs = 0;        // esp_timer-Zeitpunkt der DAC-Übernahme
+  uint32_t latenzNs = 0;     // LDAC-Flanke bis Marker-Flanke
+  uint8_t kanal = 0;
+  char text[MARKER_TEXT_LAENGE] = {};
+};
+
+struct MarkerStatistik {
+  uint32_t anzahl = 0;
+  uint32_t maxLatenzNs = 0;
+  uint64_t summeLatenzNs = 0;
+};
+
+// "/x.txt" -> "/x.mrk"
+String markerPfad(const String& textPfad);
+
+// Liest die Begleitdatei (falls vorhanden); Samplenummern erst nach setzeMarkerRate()
+bool ladeMarkerDatei(const String& pfad, std::vector<Marker>& marker);
+
+// Rechnet Zeitangaben mit der Abtastrate der Wiedergabe in Samples um und
+// sortiert nach Samplenummer (beim Armieren bzw. Laden eines Segments)
+void setzeMarkerRate(std::vector<Marker>& marker, float abtastrateHz);
+
+// Protokoll (Ringpuffer, vom Abspiel-Task beschrieben)
+void loescheMarkerProtokoll();
+void protokolliereMarker(const MarkerEreignis& ereignis);
+size_t leseMarkerProtokoll(MarkerEreignis* ziel, size_t maxAnzahl, MarkerStatistik& statistik);
+
+#endif // MARKER_HPP
@@ -24,7 +24,12 @@ void initPinModes() {
   pinMode(RST, OUTPUT);
   pinMode(Load_Data, OUTPUT);
   pinMode(R_W, OUTPUT);
-  pinMode(CS, OUTPUT);
-  digitalWrite(CS, HIGH); // Inaktiv setzen
+  pinMode(MARKER_PIN, OUTPUT);
+  digitalWrite(MARKER_PIN, LOW);
+  const uint8_t csPins[DAC_ANZAHL] = DAC_CS_PINS;
+  for (uint8_t pin : csPins) {
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, HIGH); // Inaktiv setzen
+  }
   
 }
@@ -29,6 +29,35 @@
 // Steuerleitungen (weitere)
 #define R_W        11        
 
+// Trigger-Ausgang für Marker (freier GPIO, per Build-Flag änderbar)
+#ifndef MARKER_PIN
+#define MARKER_PIN  2
+#endif
+
+// Sync-Leitung für den Gleichlauf mehrerer Geräte (siehe Synchronisation.hpp)
+#ifndef SYNC_PIN
+#define SYNC_PIN    1
+#endif
+
+// Trigger-Eingang für Start/Stopp/Weiter (siehe Trigger.hpp)
+#ifndef TRIGGER_PIN
+#define TRIGGER_PIN 7
+#endif
+
+// DAC8412-Bausteine: teilen Daten-, Adress-, R/W- und LDAC-Leitungen,
+// jeder Baustein hat eine eigene Chip-Select-Leitung.
+// Weitere Bausteine per Build-Flag, z. B. -DDAC_ANZAHL=4 -DDAC_CS_PINS="{3,4,5,6}"
+#ifndef DAC_ANZAHL
+#define DAC_ANZAHL      1
+#endif
+#ifndef DAC_CS_PINS
+#define DAC_CS_PINS     { CS }
+#endif
+
+// Je DAC8412 4 Ausgangskanäle (A–D)
+#define KANAELE_PRO_DAC 4
+#define ANZAHL_KANAELE  (DAC_ANZAHL * KANAELE_PRO_DAC)
+
 void initPinModes();
 #endif // PINMAPPING_HPP
 
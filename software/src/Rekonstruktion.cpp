@@ -0,0 +1,99 @@
+#include "Rekonstruktion.hpp"
+#include <math.h>
+
+#define DAC_MITTE  2048
+#define DAC_MAX    4095
+
+FilterEinstellung begrenzeFilterEinstellung(FilterEinstellung e) {
+  if (e.faktor < 1) e.faktor = 1;
+  if (e.faktor > FILTER_MAX_FAKTOR) e.faktor = FILTER_MAX_FAKTOR;
+  if (e.tapsProPhase < 1) e.tapsProPhase = 1;
+  if (e.tapsProPhase > FILTER_MAX_TAPS_PRO_PHASE) e.tapsProPhase = FILTER_MAX_TAPS_PRO_PHASE;
+  if (!(e.grenzfrequenz > 0.05f)) e.grenzfrequenz = 0.05f;
+  if (e.grenzfrequenz > 1.0f) e.grenzfrequenz = 1.0f;
+  return e;
+}
+
+uint32_t frameKostenNs(const FilterEinstellung& einstellung, uint16_t kanaele) {
+  const FilterEinstellung e = begrenzeFilterEinstellung(einstellung);
+  uint32_t proKanal = TAKT_KANAL_NS;
+  if (e.aktiv()) proKanal += (uint32_t)e.tapsProPhase * TAKT_FILTER_TAP_NS;
+  return TAKT_AUFWECKEN_NS + TAKT_UEBERNAHME_NS + (uint32_t)kanaele * proKanal;
+}
+
+float maxAusgabetaktHz(const FilterEinstellung& einstellung, uint16_t kanaele) {
+  return 1e9f * TAKT_BUDGET_PROZENT / 100.0f / (float)frameKostenNs(einstellung, kanaele);
+}
+
+void entwerfeFilter(const FilterEinstellung& einstellung, InterpolationsFilter& filter) {
+  const FilterEinstellung e = begrenzeFilterEinstellung(einstellung);
+  const int L = e.faktor;
+  const int T = e.tapsProPhase;
+  const int N = L * T;
+  const double mitte = (N - 1) / 2.0;
+  const double fc = e.grenzfrequenz * 0.5 / L;   // bezogen auf den Ausgabetakt
+
+  filter.faktor = (uint8_t)L;
+  filter.taps = (uint8_t)T;
+
+  for (int p = 0; p < L; ++p) {
+    double h[FILTER_MAX_TAPS_PRO_PHASE];
+    double summe = 0.0;
+    for (int k = 0; k < T; ++k) {
+      int n = p + k * L;
+      double x = n - mitte;
+      double sinc = (fabs(x) < 1e-9) ? 2.0 * fc : sin(2.0 * M_PI * fc * x) / (M_PI * x);
+      double fenster = (N > 1) ? 0.42 - 0.5 * cos(2.0 * M_PI * n / (N - 1)) + 0.08 * cos(4.0 * M_PI * n / (N - 1)) : 1.0;
+      h[k] = sinc * fenster;
+      summe += h[k];
+    }
+
+    // Jede Phase auf Gleichanteil 1 normieren, Rundungsrest auf den größten Koeffizienten
+    int32_t qSumme = 0;
+    int groesster = 0;
+    for (int k = 0; k < T; ++k) {
+      double normiert = (fabs(summe) > 1e-12) ? h[k] / summe : (k == 0 ? 1.0 : 0.0);
+      filter.koeff[p][k] = (int16_t)lround(normiert * (1 << FILTER_Q));
+      qSumme += filter.koeff[p][k];
+      if (abs(filter.koeff[p][k]) > abs(filter.koeff[p][groesster])) groesster = k;
+    }
+    filter.koeff[p][groesster] += (int16_t)((1 << FILTER_Q) - qSumme);
+    for (int k = T; k < FILTER_MAX_TAPS_PRO_PHASE; ++k) filter.koeff[p][k] = 0;
+  }
+}
+
+uint16_t gruppenlaufzeit(const InterpolationsFilter& filter) {
+  return (uint16_t)(filter.faktor * filter.taps / 2);
+}
+
+void setzeFilterZustand(const InterpolationsFilter& filter, FilterZustand& zustand, uint16_t code) {
+  int16_t wert = (int16_t)code - DAC_MITTE;
+  for (int k = 0; k < 2 * FILTER_MAX_TAPS_PRO_PHASE; ++k) zustand.verlauf[k] = wert;
+  zustand.pos = 0;
+  (void)filter;
+}
+
+void interpoliereBlock(const InterpolationsFilter& filter, FilterZustand& zustand,
+                       const uint16_t* ein, size_t anzahl, uint16_t* aus) {
+  const uint8_t L = filter.faktor;
+  const uint8_t T = filter.taps;
+
+  for (size_t i = 0; i < anzahl; ++i) {
+    // Neuen Wert vorne in den Ringpuffer (beide Hälften)
+    zustand.pos = (zustand.pos == 0) ? T - 1 : zustand.pos - 1;
+    int16_t x = (int16_t)ein[i] - DAC_MITTE;
+    zustand.verlauf[zustand.pos] = x;
+    zustand.verlauf[zustand.pos + T] = x;
+    const int16_t* v = &zustand.verlauf[zustand.pos];
+
+    for (uint8_t p = 0; p < L; ++p) {
+      const int16_t* h = filter.koeff[p];
+      int32_t akku = 1 << (FILTER_Q - 1);
+      for (uint8_t k = 0; k < T; ++k) akku += (int32_t)h[k] * v[k];
+      int32_t y = (akku >> FILTER_Q) + DAC_MITTE;
+      if (y < 0) y = 0;
+      if (y > DAC_MAX) y = DAC_MAX;
+      *aus++ = (uint16_t)y;
+    }
+  }
+}
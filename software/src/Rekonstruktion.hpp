@@ -0,0 +1,71 @@
+#ifndef REKONSTRUKTION_HPP
+#define REKONSTRUKTION_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Digitale Rekonstruktion vor dem DAC: Überabtastung um 'faktor' mit
+// polyphasigem FIR-Tiefpass (Festkomma, Q14). Ersetzt die Treppenstufen
+// des Halteglieds durch interpolierte Zwischenwerte; mit faktor = 1 und
+// grenzfrequenz < 1 wirkt das Filter als reine Glättung.
+
+#define FILTER_MAX_FAKTOR          8
+#define FILTER_MAX_TAPS_PRO_PHASE  16
+#define FILTER_Q                   14
+
+struct FilterEinstellung {
+  uint8_t faktor = 1;            // Ausgabetakt = Quelltakt * faktor
+  uint8_t tapsProPhase = 8;      // Filterlänge = faktor * tapsProPhase
+  float grenzfrequenz = 1.0f;    // relativ zur Nyquist-Frequenz der Quelle (0..1]
+
+  bool aktiv() const { return faktor > 1 || grenzfrequenz < 1.0f; }
+};
+
+// Vorberechnete Koeffizienten, zeilenweise pro Phase
+struct InterpolationsFilter {
+  uint8_t faktor = 1;
+  uint8_t taps = 1;
+  int16_t koeff[FILTER_MAX_FAKTOR][FILTER_MAX_TAPS_PRO_PHASE] = {};
+};
+
+// Verlauf der letzten Eingangswerte eines Kanals (doppelt abgelegt,
+// damit das Skalarprodukt ohne Modulo über den Ringpuffer läuft)
+struct FilterZustand {
+  int16_t verlauf[2 * FILTER_MAX_TAPS_PRO_PHASE] = {};
+  uint8_t pos = 0;
+};
+
+// Zeitbudget eines Ausgabeframes, Richtwerte für den ESP32-S3 bei 240 MHz:
+// Aufwecken über esp_timer und Semaphore, pro Kanal Bus und CS-Puls
+// (DacBus.hpp) samt Konvertierung, pro Tap und Kanal ein MAC im Filter.
+// Ein Takt gilt als machbar, solange ein Frame höchstens TAKT_BUDGET_PROZENT
+// der Periode belegt; der Rest bleibt für die Blockumrechnung und ISRs.
+#define TAKT_AUFWECKEN_NS    15000
+#define TAKT_UEBERNAHME_NS   500
+#define TAKT_KANAL_NS        1000
+#define TAKT_FILTER_TAP_NS   15
+#define TAKT_BUDGET_PROZENT  50
+
+// Geschätzte Dauer eines Ausgabeframes für 'kanaele' Kanäle
+uint32_t frameKostenNs(const FilterEinstellung& einstellung, uint16_t kanaele);
+// Höchster Ausgabetakt (Quelltakt * faktor) im Zeitbudget
+float maxAusgabetaktHz(const FilterEinstellung& einstellung, uint16_t kanaele);
+
+// Prüft und begrenzt die Einstellung auf die unterstützten Werte
+FilterEinstellung begrenzeFilterEinstellung(FilterEinstellung einstellung);
+
+// Gefenstertes Sinc (Blackman), jede Phase auf Gleichanteil 1 normiert
+void entwerfeFilter(const FilterEinstellung& einstellung, InterpolationsFilter& filter);
+
+// Verzögerung des Filters in Ausgabeframes: ein Quellsample erscheint
+// (faktor * taps) / 2 Frames nach seinem eigenen Frame (linearphasig)
+uint16_t gruppenlaufzeit(const InterpolationsFilter& filter);
+
+// Füllt den Verlauf mit einem Startwert (vermeidet Einschwingen ab 0)
+void setzeFilterZustand(const InterpolationsFilter& filter, FilterZustand& zustand, uint16_t code);
+
+// Verarbeitet 'anzahl' DAC-Codes zu 'anzahl * faktor' interpolierten Codes
+void interpoliereBlock(const InterpolationsFilter& filter, FilterZustand& zustand,
+                       const uint16_t* ein, size_t anzahl, uint16_t* aus);
+
+#endif // REKONSTRUKTION_HPP
@@ -1,26 +1,55 @@
 #include "Server.hpp"
+#include "Konfiguration.hpp"
 #include <WiFi.h>
 #include <esp_event.h>
 #include <esp_netif.h>
 
-int ausgabeFrequenzHz = 100; // Default
+float ausgabeFrequenzHz = 100.0f; // Default
 
-void ladeFrequenzAusDatei() {
-    File f = SPIFFS.open("/freq.cfg", "r");
-    if (f) {
-        String val = f.readStringUntil('\n');
-        int hz = val.toInt();
-        if (hz >= 1 && hz <= 1000) ausgabeFrequenzHz = hz;
-        f.close();
+// Kalibrierung eines Kanals für /calibration und /config
+static void kalibrierungAlsJson(int kanal, JsonObject obj) {
+    const KanalKalibrierung& k = holeKalibrierung(kanal);
+    obj["channel"] = kanalName(kanal);
+    obj["gain"] = k.gain;
+    obj["offset"] = k.offset;
+    JsonArray punkte = obj["points"].to<JsonArray>();
+    for (uint8_t i = 0; i < k.anzahlStuetzstellen; ++i) {
+        JsonArray p = punkte.add<JsonArray>();
+        p.add(k.stuetzCode[i]);
+        p.add(k.korrektur[i]);
     }
 }
 
-void speichereFrequenzInDatei(int hz) {
-    File f = SPIFFS.open("/freq.cfg", "w");
-    if (f) {
-        f.println(hz);
-        f.close();
+// Erwartet {"channel":"CH_A","gain":1.0,"offset":0.0,"points":[[code,korrektur],...]}
+// Liest und prüft nur; übernommen wird mit setzeKalibrierung()
+static bool kalibrierungAusJson(JsonObjectConst obj, int& kanal, KanalKalibrierung& k, String& fehler) {
+    kanal = kanalIndexAusName(obj["channel"] | "");
+    if (kanal < 0) {
+        fehler = "Ungültiger Kanal";
+        return false;
     }
+    k = KanalKalibrierung();
+    k.gain = obj["gain"] | 1.0f;
+    k.offset = obj["offset"] | 0.0f;
+    JsonArrayConst punkte = obj["points"].as<JsonArrayConst>();
+    for (JsonArrayConst p : punkte) {
+        if (k.anzahlStuetzstellen >= KALIBRIERUNG_STUETZSTELLEN) break;
+        // Als int32_t lesen: eine stille Verengung ließe z. B. Code 65636 als 100 durch
+        const int32_t code = p[0] | (int32_t)-1;
+        const int32_t korrektur = p[1] | (int32_t)0;
+        if (code < 0 || code >= DAC_CODES || korrektur < INT16_MIN || korrektur > INT16_MAX) {
+            fehler = "Stützstelle außerhalb des Wertebereichs";
+            return false;
+        }
+        k.stuetzCode[k.anzahlStuetzstellen] = (uint16_t)code;
+        k.korrektur[k.anzahlStuetzstellen] = (int16_t)korrektur;
+        k.anzahlStuetzstellen++;
+    }
+    if (!kalibrierungGueltig(k)) {
+        fehler = "Ungültige Kalibrierdaten";
+        return false;
+    }
+    return true;
 }
 
 void setupRoutes(AsyncWebServer& server) {
@@ -39,54 +68,180 @@ void setupRoutes(AsyncWebServer& server) {
     });
 }
   
-  std::vector<float> extractNumbersRegex(const String &content) {
-    std::vector<float> numbers;
-    std::string s = content.c_str();
-    std::regex floatRegex("-?[0-9]+(?:\\.[0-9]+)?");
-    auto numbersBegin = std::sregex_iterator(s.begin(), s.end(), floatRegex);
-    auto numbersEnd = std::sregex_iterator();
-    for (std::sregex_iterator i = numbersBegin; i != numbersEnd; ++i) {
-  std::smatch match = *i;
-  float value = atof(match.str().c_str());
-  numbers.push_back(value);
+  void sendeJson(AsyncWebServerRequest* request, const JsonDocument& doc, int code) {
+    AsyncResponseStream* antwort = request->beginResponseStream("application/json", measureJson(doc) + 1);
+    antwort->setCode(code);
+    serializeJson(doc, *antwort);
+    request->send(antwort);
+  }
+
+  ActiveUpload* belegeUpload(AsyncWebServerRequest* request) {
+    for (ActiveUpload& upload : activeUploads) {
+      if (upload.request == nullptr) {
+        upload.request = request;
+        return &upload;
+      }
     }
-    return numbers;
+    return nullptr;
   }
-  
+
+  ActiveUpload* findeUpload(AsyncWebServerRequest* request) {
+    for (ActiveUpload& upload : activeUploads) {
+      if (upload.request == request) return &upload;
+    }
+    return nullptr;
+  }
+
+  void gebeUploadFrei(ActiveUpload& upload) {
+    if (upload.file) upload.file.close();
+    upload.request = nullptr;
+    upload.umwandeln = false;
+    upload.nurUmgewandelt = false;
+    upload.leser.zuruecksetzen();
+    // Zahlenpuffer kann mehrere 100 kB groß sein: nicht im Platz behalten
+    std::vector<float>().swap(upload.werte);
+    std::vector<float>().swap(upload.stueck);
+  }
+
+  // Uploads ohne Platz oder ohne Zieldatei: die Abschlussantwort meldet den
+  // Fehler statt "Upload erfolgreich". Ring über die Anfragen, der Eintrag
+  // wird mit der Antwort bzw. beim Trennen der Verbindung gelöscht.
+  struct UploadFehler {
+    AsyncWebServerRequest* request = nullptr;
+    int code = 0;
+    const char* meldung = "";
+  };
+  static std::array<UploadFehler, UPLOAD_PLAETZE> uploadFehler;
+  static size_t naechsterUploadFehler = 0;
+
+  static bool nimmUploadFehler(AsyncWebServerRequest* request, UploadFehler& fehler) {
+    for (UploadFehler& f : uploadFehler) {
+      if (f.request == request) {
+        fehler = f;
+        f = UploadFehler();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static void merkeUploadFehler(AsyncWebServerRequest* request, int code, const char* meldung) {
+    UploadFehler& f = uploadFehler[naechsterUploadFehler];
+    naechsterUploadFehler = (naechsterUploadFehler + 1) % uploadFehler.size();
+    f.request = request;
+    f.code = code;
+    f.meldung = meldung;
+    request->onDisconnect([request]() {
+      UploadFehler verworfen;
+      nimmUploadFehler(request, verworfen);
+    });
+  }
+
+  // Pfad der komprimierten Fassung einer Textdatei ("/x.txt" -> "/x.eegz")
+  String cachePfad(const String& textPfad) {
+    String basis = textPfad;
+    if (basis.endsWith(".txt")) basis = basis.substring(0, basis.length() - 4);
+    return basis + CACHE_ENDUNG;
+  }
+
+  bool ladeKanalCache(const String& pfad, std::vector<float>& werte) {
+    if (!SPIFFS.exists(pfad)) return false;
+    File file = SPIFFS.open(pfad, "r");
+    if (!file) return false;
+    std::vector<uint8_t> daten(file.size());
+    size_t gelesen = file.read(daten.data(), daten.size());
+    file.close();
+    if (gelesen != daten.size() || !dekodiereSamples(daten.data(), daten.size(), werte)) {
+      Serial.println("⚠️ Cache ungültig, wird neu erzeugt: " + pfad);
+      SPIFFS.remove(pfad);
+      werte.clear();
+      return false;
+    }
+    return true;
+  }
+
+  bool speichereKanalCache(const String& pfad, const std::vector<float>& werte, size_t& bytes) {
+    std::vector<uint8_t> daten;
+    if (!kodiereSamples(werte.data(), werte.size(), daten)) {
+      Serial.println("⚠️ Werte mit mehr als 3 Nachkommastellen, Cache auf 1 µV gerundet: " + pfad);
+    }
+    File file = SPIFFS.open(pfad, "w");
+    if (!file) return false;
+    bytes = file.write(daten.data(), daten.size());
+    file.close();
+    if (bytes != daten.size()) {
+      SPIFFS.remove(pfad);
+      return false;
+    }
+    return true;
+  }
+
+  bool ladeSignaldatei(const String& pfad, std::vector<float>& werte, SignalLadeInfo& info) {
+    info = SignalLadeInfo();
+    String cache = cachePfad(pfad);
+    info.ausCache = ladeKanalCache(cache, werte);
+    if (info.ausCache) return true;
+    if (!SPIFFS.exists(pfad)) return false;
+
+    File file = SPIFFS.open(pfad, "r");
+    if (!file) return false;
+    // Stückweise lesen statt den ganzen Text als String aufzubauen
+    werte.clear();
+    werte.reserve(file.size() / 8);   // grob 8 Zeichen pro Zahl
+    Zahlenleser leser;
+    uint8_t stueck[512];
+    size_t gelesen;
+    while ((gelesen = file.read(stueck, sizeof(stueck))) > 0) leser.verarbeite(stueck, gelesen, werte);
+    leser.beende(werte);
+    file.close();
+    info.textBytes = leser.gelesenBytes();
+
+    // Komprimierte Fassung für den nächsten Ladevorgang ablegen
+    if (!werte.empty()) speichereKanalCache(cache, werte, info.cacheBytes);
+    return true;
+  }
+
+  bool signaldateiVorhanden(const String& pfad) {
+    return SPIFFS.exists(pfad) || SPIFFS.exists(cachePfad(pfad));
+  }
+
   String generateUniqueFileName(const String& baseName) {
     String uniqueName = baseName;
     int counter = 1;
-    while (SPIFFS.exists("/" + uniqueName)) {
+    while (signaldateiVorhanden("/" + uniqueName)) {
       uniqueName = baseName + "(" + String(counter++) + ")";
     }
     return uniqueName;
   }
   
-  String getUploadedFilesList() {
-    String filesList = "{\"files\":[";
+  void sammleDateiliste(JsonArray dateien) {
     File root = SPIFFS.open("/");
     File file = root.openNextFile();
-    bool first = true;
     while (file) {
-      if (!first) filesList += ",";
       String name = String(file.name());
       if (name.startsWith("/")) name = name.substring(1);
-      filesList += "\"" + name + "\"";
-      first = false;
+      // Wiedergabebild und seine temporäre Fassung sind keine Signaldateien
+      if ("/" + name == WIEDERGABEBILD_PFAD || "/" + name == WIEDERGABEBILD_TEMP) {
+        file = root.openNextFile();
+        continue;
+      }
+      if (name.endsWith(CACHE_ENDUNG)) {
+        // Komprimierte Caches nur anstelle einer fehlenden Textdatei anzeigen
+        String text = name.substring(0, name.length() - strlen(CACHE_ENDUNG)) + ".txt";
+        if (SPIFFS.exists("/" + text)) {
+          file = root.openNextFile();
+          continue;
+        }
+        name = text;
+      }
+      dateien.add(name);
       file = root.openNextFile();
     }
-    filesList += "]}";
-    return filesList;
   }
   
   void setupWebServer() {
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-      if (SPIFFS.exists("/HTML_Server.html")) {
-        request->send(SPIFFS, "/HTML_Server.html", "text/html");
-      } else {
-        request->send(404, "text/plain", "Fehler: HTML_Server.html nicht gefunden.");
-      }
-    });
+    // "/", script.js und Logo aus dem Flash (gzip, ETag, Cache-Control)
+    registriereWebOberflaeche(server);
   
     server.onNotFound([](AsyncWebServerRequest *request) {
       request->redirect("/");
@@ -100,60 +255,144 @@ void setupRoutes(AsyncWebServer& server) {
       request->redirect("/");
     });
   
-    server.on("/HS-Wismar_Logo-FIW_V1_RGB.png", HTTP_GET, [](AsyncWebServerRequest *request) {
-      if (SPIFFS.exists("/HS-Wismar_Logo-FIW_V1_RGB.png")) {
-        request->send(SPIFFS, "/HS-Wismar_Logo-FIW_V1_RGB.png", "image/png");
-      } else {
-        request->send(404, "text/plain", "Fehler: Logo nicht gefunden.");
-      }
-    });
-  
     server.on("/storage", HTTP_GET, [](AsyncWebServerRequest *request) {
-      size_t totalBytes = SPIFFS.totalBytes();
-      size_t usedBytes = SPIFFS.usedBytes();
-      String json = "{";
-      json += "\"total\": " + String(totalBytes) + ",";
-      json += "\"used\": " + String(usedBytes);
-      json += "}";
-      request->send(200, "application/json", json);
+      JsonDocument doc;
+      doc["total"] = SPIFFS.totalBytes();
+      doc["used"] = SPIFFS.usedBytes();
+      sendeJson(request, doc);
+    });
+
+    // Heap-Zustand: über lange Läufe sollten largestBlock und fragmentation stabil bleiben
+    server.on("/heap", HTTP_GET, [](AsyncWebServerRequest *request) {
+      HeapStatistik h = holeHeapStatistik();
+      JsonDocument doc;
+      doc["free"] = h.frei;
+      doc["largestBlock"] = h.groessterBlock;
+      doc["minFree"] = h.minimumFrei;
+      doc["allocatedBlocks"] = h.belegteBloecke;
+      doc["freeBlocks"] = h.freieBloecke;
+      doc["fragmentation"] = h.fragmentierung;
+      doc["psramFree"] = h.psramFrei;
+      doc["psramLargestBlock"] = h.psramGroessterBlock;
+      doc["guard"] = heapWaechterAktiv();
+      sendeJson(request, doc);
     });
   
     server.on("/upload", HTTP_POST,
       [](AsyncWebServerRequest *request) {
+        UploadFehler fehler;
+        if (nimmUploadFehler(request, fehler)) {
+          request->send(fehler.code, "text/plain", fehler.meldung);
+          return;
+        }
         request->send(200, "text/plain", "Upload erfolgreich");
       },
+      // ?convert=1: Zahlen schon beim Empfang lesen und die .eegz-Fassung mit ablegen,
+      // ?convert=only: nur die .eegz-Fassung (spart Flash, Text nicht mehr abrufbar)
       [](AsyncWebServerRequest *request, const String &filename, size_t index, uint8_t *data, size_t len, bool final) {
         if (index == 0) {
-          String path = "/" + generateUniqueFileName(filename);
-          File file = SPIFFS.open(path, "w");
-          if (!file) {
-            Serial.println("Fehler beim Öffnen der Datei: " + path);
+          ActiveUpload* platz = belegeUpload(request);
+          if (platz == nullptr) {
+            Serial.println("⚠️ Alle Upload-Plätze belegt, verwerfe " + filename);
+            merkeUploadFehler(request, 503, "Alle Upload-Plätze belegt, bitte später erneut senden");
             return;
           }
-          ActiveUpload au;
-          au.file = file;
-          au.path = path;
-          activeUploads[request] = au;
+          ActiveUpload& au = *platz;
+          au.path = "/" + generateUniqueFileName(filename);
+          String modus = request->hasParam("convert") ? request->getParam("convert")->value() : "";
+          // Nur Signaldateien; Szenarien (.json) und Marker (.mrk) bleiben Text
+          au.umwandeln = (modus == "1" || modus == "only") && au.path.endsWith(".txt");
+          au.nurUmgewandelt = au.umwandeln && modus == "only";
+          // Der Zahlenpuffer wird einmal reserviert und wächst im AsyncTCP-Callback
+          // nicht nach: mit Textdatei grob 8 Zeichen pro Zahl (dichtere Dateien
+          // wandelt erst das erste Laden um), ohne Textdatei für den schlechtesten
+          // Fall (jedes zweite Zeichen eine Zahl)
+          const size_t erwartet = request->contentLength() / 8 + 1;
+          const size_t hoechstens = request->contentLength() / 2 + 1;
+          if (au.nurUmgewandelt && request->contentLength() == 0) {
+            // Chunked oder ohne Längenangabe: Puffer nicht abschätzbar
+            Serial.println("⚠️ Länge unbekannt für convert=only, speichere zusätzlich den Text");
+            au.nurUmgewandelt = false;
+          }
+          if (au.nurUmgewandelt && hoechstens * sizeof(float) * 2 > ESP.getMaxAllocHeap()) {
+            Serial.println("⚠️ Zu wenig Speicher für convert=only, speichere zusätzlich den Text");
+            au.nurUmgewandelt = false;
+          }
+          if (au.umwandeln && erwartet * sizeof(float) * 2 > ESP.getMaxAllocHeap()) {
+            Serial.println("⚠️ Zu wenig Speicher für die Umwandlung beim Upload, speichere nur Text");
+            au.umwandeln = false;
+            au.nurUmgewandelt = false;
+          }
+          if (au.umwandeln) au.werte.reserve(au.nurUmgewandelt ? hoechstens : erwartet);
+          if (!au.nurUmgewandelt) {
+            au.file = SPIFFS.open(au.path, "w");
+            if (!au.file) {
+              Serial.println("Fehler beim Öffnen der Datei: " + au.path);
+              gebeUploadFrei(au);
+              merkeUploadFehler(request, 500, "Datei konnte nicht angelegt werden");
+              return;
+            }
+          }
+          // Abgebrochene Verbindung: Platz freigeben, halbe Datei entfernen
+          request->onDisconnect([request]() {
+            ActiveUpload* offen = findeUpload(request);
+            if (offen == nullptr) return;
+            String pfad = offen->path;
+            gebeUploadFrei(*offen);
+            if (SPIFFS.exists(pfad)) SPIFFS.remove(pfad);
+            Serial.println("⚠️ Upload abgebrochen: " + pfad);
+          });
         }
-        if (activeUploads.find(request) != activeUploads.end()) {
-          activeUploads[request].file.write(data, len);
+        ActiveUpload* platz = findeUpload(request);
+        if (platz == nullptr) return;
+        ActiveUpload& au = *platz;
+        if (au.file) au.file.write(data, len);
+        if (au.umwandeln) {
+          au.stueck.clear();
+          au.leser.verarbeite(data, len, au.stueck);
+          if (final) au.leser.beende(au.stueck);
+          if (au.werte.size() + au.stueck.size() > au.werte.capacity()) {
+            if (au.nurUmgewandelt) {
+              // Ohne Textdatei bliebe nichts übrig: Upload als fehlgeschlagen melden
+              Serial.println("⚠️ Mehr Zahlen als Platz im Puffer, convert=only verworfen: " + au.path);
+              gebeUploadFrei(au);
+              merkeUploadFehler(request, 507, "Zu viele Zahlen für convert=only, bitte mit convert=1 senden");
+              return;
+            }
+            // Dichter als geschätzt: nicht nachfordern, die Textdatei bleibt
+            Serial.println("⚠️ Mehr Zahlen als erwartet, Umwandlung beim ersten Laden: " + au.path);
+            au.umwandeln = false;
+            std::vector<float>().swap(au.werte);
+          } else {
+            au.werte.insert(au.werte.end(), au.stueck.begin(), au.stueck.end());
+          }
         }
         if (final) {
-          if (activeUploads.find(request) != activeUploads.end()) {
-            activeUploads[request].file.close();
-            FileData fd;
-            fd.filename = activeUploads[request].path;
-            uploadedFiles.push_back(fd);
-            activeUploads.erase(request);
-            Serial.println("Datei gespeichert: " + fd.filename);
+          if (au.file) au.file.close();
+          if (au.umwandeln) {
+            size_t bytes = 0;
+            if (!au.werte.empty() && speichereKanalCache(cachePfad(au.path), au.werte, bytes)) {
+              Serial.printf("Beim Upload umgewandelt: %u Zahlen, %u -> %u Bytes\n",
+                            (unsigned)au.werte.size(), (unsigned)au.leser.gelesenBytes(), (unsigned)bytes);
+            } else {
+              Serial.println("⚠️ Umwandlung beim Upload fehlgeschlagen: " + au.path);
+              if (au.nurUmgewandelt) {
+                gebeUploadFrei(au);
+                merkeUploadFehler(request, 500, "Umwandlung fehlgeschlagen, nichts gespeichert");
+                return;
+              }
+            }
           }
+          Serial.println("Datei gespeichert: " + au.path);
+          gebeUploadFrei(au);
         }
       }
     );
   
     server.on("/getFiles", HTTP_GET, [](AsyncWebServerRequest *request) {
-      String filesList = getUploadedFilesList();
-      request->send(200, "application/json", filesList);
+      JsonDocument doc;
+      sammleDateiliste(doc["files"].to<JsonArray>());
+      sendeJson(request, doc);
     });
   
     server.on("/delete", HTTP_DELETE, [](AsyncWebServerRequest *request) {
@@ -162,15 +401,85 @@ void setupRoutes(AsyncWebServer& server) {
         return;
       }
       String fileName = "/" + request->getParam("name")->value();
-      if (SPIFFS.exists(fileName)) {
-        SPIFFS.remove(fileName);
+      if (signaldateiVorhanden(fileName)) {
+        if (SPIFFS.exists(fileName)) SPIFFS.remove(fileName);
+        String cache = cachePfad(fileName);
+        if (SPIFFS.exists(cache)) SPIFFS.remove(cache);
         request->send(200, "text/plain", "Datei erfolgreich gelöscht.");
       } else {
         request->send(404, "text/plain", "Datei nicht gefunden.");
       }
     });
-  
+
+    // Min/Max je Abschnitt, höchstens 'points' Werte unabhängig von der Dateigröße
+    server.on("/preview", HTTP_GET, [](AsyncWebServerRequest *request) {
+      if (!request->hasParam("file")) {
+        request->send(400, "text/plain", "Fehler: Kein Dateiname angegeben.");
+        return;
+      }
+      String fileName = "/" + request->getParam("file")->value();
+      if (!signaldateiVorhanden(fileName)) {
+        request->send(404, "text/plain", "Datei nicht gefunden.");
+        return;
+      }
+      long punkte = request->hasParam("points") ? request->getParam("points")->value().toInt()
+                                                : VORSCHAU_STANDARD_PUNKTE;
+      long von = request->hasParam("from") ? request->getParam("from")->value().toInt() : 0;
+      long bis = request->hasParam("to") ? request->getParam("to")->value().toInt() : 0;
+      if (punkte < 1 || punkte > VORSCHAU_MAX_PUNKTE || von < 0 || bis < 0 || (bis > 0 && bis <= von)) {
+        request->send(400, "text/plain", "Fehler: points 1–" + String(VORSCHAU_MAX_PUNKTE) +
+                      ", 0 ≤ from < to");
+        return;
+      }
+
+      // Nur aus der .eegz-Fassung; den Text hier zu parsen hielte den AsyncTCP-Task auf
+      if (!SPIFFS.exists(cachePfad(fileName))) {
+        request->send(409, "text/plain",
+                      "Fehler: Datei zuerst umwandeln (Upload mit convert=1 oder /processFiles)");
+        return;
+      }
+
+      Vorschau v;
+      String fehler;
+      if (!berechneVorschau(fileName, (uint32_t)von, (uint32_t)bis, (uint16_t)punkte, v, fehler)) {
+        request->send(400, "text/plain", "Fehler: " + fehler);
+        return;
+      }
+
+      if (request->hasParam("format") && request->getParam("format")->value() == "bin") {
+        AsyncResponseStream *response = request->beginResponseStream("application/octet-stream");
+        response->addHeader("X-Samples", String(v.sampleAnzahl));
+        response->addHeader("X-From", String(v.von));
+        response->addHeader("X-To", String(v.bis));
+        for (size_t i = 0; i < v.minMv.size(); ++i) {
+          response->write((const uint8_t*)&v.minMv[i], sizeof(float));
+          response->write((const uint8_t*)&v.maxMv[i], sizeof(float));
+        }
+        request->send(response);
+        return;
+      }
+
+      JsonDocument doc;
+      doc["file"] = request->getParam("file")->value();
+      doc["samples"] = v.sampleAnzahl;
+      doc["from"] = v.von;
+      doc["to"] = v.bis;
+      doc["points"] = v.minMv.size();
+      JsonArray minArr = doc["min"].to<JsonArray>();
+      JsonArray maxArr = doc["max"].to<JsonArray>();
+      for (size_t i = 0; i < v.minMv.size(); ++i) {
+        minArr.add(v.minMv[i]);
+        maxArr.add(v.maxMv[i]);
+      }
+      sendeJson(request, doc);
+    });
+
     server.on("/processFiles", HTTP_POST, [](AsyncWebServerRequest *request) {
+      // Der Abspiel-Task liest die Kanaltabelle ohne Sperre
+      if (wiedergabeAktiv()) {
+        request->send(409, "text/plain", "Wiedergabe läuft, zuerst /stop");
+        return;
+      }
       String channelsJson = "";
       if (request->hasParam("channels", true)) {
         channelsJson = request->getParam("channels", true)->value();
@@ -187,8 +496,14 @@ void setupRoutes(AsyncWebServer& server) {
       }
   
       JsonArray channelsArray = doc.as<JsonArray>();
-      // Map zum Sammeln aller Zahlen pro Kanal in Reihenfolge
-      std::map<String, std::vector<float>> tempKanalDaten;
+      // Tabelle zum Sammeln aller Zahlen pro Kanal in Reihenfolge
+      KanalTabelle neueTabelle;
+      // Samples in mV bis zur Festlegung des Bereichs, danach als Q15 in die Tabelle
+      std::array<std::vector<float>, ANZAHL_KANAELE> rohwerte;
+      // Gewünschter Amplitudenbereich, Abtastrate und Startversatz pro Kanal
+      // (erster Eintrag eines Kanals zählt)
+      std::array<KanalSkalierung, ANZAHL_KANAELE> bereichsWahl;
+      std::array<bool, ANZAHL_KANAELE> bereichGewaehlt = {};
   
       for (JsonObject elem : channelsArray) {
         const char* name = elem["name"];
@@ -198,73 +513,379 @@ void setupRoutes(AsyncWebServer& server) {
         JsonObject res = results.add<JsonObject>();
         res["filename"] = String(name);
         res["channel"] = channel;
+
+        int kanalIndex = kanalIndexAusName(channel ? channel : "");
+        if (kanalIndex < 0) {
+          res["error"] = "Unbekannter Kanal.";
+          res["selfCheck"] = "Fehler";
+          continue;
+        }
+
+        if (!bereichGewaehlt[kanalIndex]) {
+          KanalSkalierung& wahl = bereichsWahl[kanalIndex];
+          const Konfiguration& k = konfiguration();
+          wahl.modus = bereichsModusAusText(elem["range"] | bereichsModusAlsText(k.bereichsModus));
+          wahl.minMv = elem["min"] | k.minMv;
+          wahl.maxMv = elem["max"] | k.maxMv;
+          bereichGewaehlt[kanalIndex] = true;
+
+          float rate = elem["rate"] | 0.0f;
+          float versatz = elem["offset"] | 0.0f;
+          if (!isfinite(rate) || rate < 0.0f || rate > 100000.0f || !isfinite(versatz) || versatz < 0.0f) {
+            res["error"] = "rate/offset ungültig.";
+            res["selfCheck"] = "Fehler";
+            bereichGewaehlt[kanalIndex] = false;
+            continue;
+          }
+          neueTabelle[kanalIndex].abtastrateHz = rate;
+          neueTabelle[kanalIndex].versatzS = versatz;
+        }
   
-        if (SPIFFS.exists(filePath)) {
-          File file = SPIFFS.open(filePath, "r");
-          if (file) {
-            String content;
-            while (file.available()) content += (char)file.read();
-            file.close();
-  
-            std::vector<float> numbers = extractNumbersRegex(content);
-  
-            // Werte anhängen, nicht überschreiben!
-            if (!numbers.empty()) {
-              auto& vec = tempKanalDaten[String(channel)];
-              vec.insert(vec.end(), numbers.begin(), numbers.end());
-            }
-  
-            if (content.length() == 0 || numbers.empty()) {
-              res["selfCheck"] = "Keine Zahlen gefunden. Datei übersprungen.";
-              res["error"] = "Keine Zahlen erkannt";
-              continue;
+        std::vector<float> numbers;
+        SignalLadeInfo info;
+        if (ladeSignaldatei(filePath, numbers, info)) {
+          // Werte anhängen, nicht überschreiben!
+          if (!numbers.empty()) {
+            auto& vec = rohwerte[kanalIndex];
+            // Marker der Begleitdatei hinter die bisherigen Samples verschieben
+            std::vector<Marker> marker;
+            // Zeitangaben rechnet erst das Armieren mit der dann gültigen Rate um
+            if (ladeMarkerDatei(markerPfad(filePath), marker)) {
+              for (Marker& m : marker) m.versatz = vec.size();
+              auto& ziel = neueTabelle[kanalIndex].marker;
+              ziel.insert(ziel.end(), marker.begin(), marker.end());
+              res["markers"] = (int)marker.size();
             }
-  
-            JsonArray nums = res["numbers"].to<JsonArray>();
-            for (float n : numbers) nums.add(n);
-  
-            res["numberCount"] = (int)numbers.size();
-            res["selfCheck"] = "OK";
-          } else {
-            res["error"] = "Fehler beim Öffnen der Datei.";
-            res["selfCheck"] = "Fehler";
+            vec.insert(vec.end(), numbers.begin(), numbers.end());
+          }
+
+          if (numbers.empty()) {
+            res["selfCheck"] = "Keine Zahlen gefunden. Datei übersprungen.";
+            res["error"] = "Keine Zahlen erkannt";
+            continue;
+          }
+
+          if (info.cacheBytes > 0) {
+            res["compressionRatio"] = (float)info.textBytes / (float)info.cacheBytes;
           }
+          res["cache"] = info.ausCache;
+
+          // Nur der Anfang: die vollständige Liste wäre ein Vielfaches der Datei
+          JsonArray nums = res["numbers"].to<JsonArray>();
+          for (size_t n = 0; n < numbers.size() && n < VERARBEITUNG_VORSCHAU_ZAHLEN; ++n) nums.add(numbers[n]);
+          if (numbers.size() > VERARBEITUNG_VORSCHAU_ZAHLEN) res["numbersTruncated"] = true;
+
+          res["numberCount"] = (int)numbers.size();
+          res["selfCheck"] = "OK";
         } else {
           res["error"] = "Datei nicht gefunden.";
           res["selfCheck"] = "Fehler";
         }
       }
   
-      // Nach dem Durchlauf: tempKanalDaten in kanalDaten übernehmen
-      kanalDaten = std::move(tempKanalDaten);
+      // Skalierung einmalig pro Kanal festlegen und die Samples nach Q15 wandeln,
+      // damit der Abspiel-Task nur noch mit Ganzzahlen rechnet
+      JsonObject bereiche = resultDoc["ranges"].to<JsonObject>();
+      for (int index = 0; index < ANZAHL_KANAELE; ++index) {
+        Kanal& kanal = neueTabelle[index];
+        std::vector<float>& werte = rohwerte[index];
+        if (werte.empty()) continue;
+        const KanalSkalierung& wahl = bereichsWahl[index];
+        float minMv = wahl.minMv;
+        float maxMv = wahl.maxMv;
+        if (wahl.modus == BereichsModus::AUTO) {
+          bestimmeBereich(werte.data(), werte.size(), minMv, maxMv);
+        }
+        kanal.skalierung = berechneSkalierung(wahl.modus, minMv, maxMv);
+        kanal.samples.resize(werte.size());
+        normiereBlock(werte.data(), werte.size(), kanal.skalierung, kanal.samples.data());
+        std::vector<float>().swap(werte);
+
+        JsonObject b = bereiche[kanalName(index)].to<JsonObject>();
+        b["mode"] = bereichsModusAlsText(kanal.skalierung.modus);
+        b["min"] = kanal.skalierung.minMv;
+        b["max"] = kanal.skalierung.maxMv;
+        if (kanal.abtastrateHz > 0.0f) b["rate"] = kanal.abtastrateHz;
+        if (kanal.versatzS > 0.0f) b["offset"] = kanal.versatzS;
+      }
+
+      // Nach dem Durchlauf: neueTabelle in kanalTabelle übernehmen (ein Trigger
+      // kann die Wiedergabe während des Ladens gestartet haben)
+      {
+        KanalTabellenSperre sperre;
+        if (!sperre.gesperrt) {
+          request->send(409, "text/plain", "Wiedergabe läuft, zuerst /stop");
+          return;
+        }
+        kanalTabelle = std::move(neueTabelle);
+      }
+      // Für den Autostart als fertig umgerechnetes Bild ablegen
+      resultDoc["imageSaved"] = speichereWiedergabebild(kanalTabelle, ausgabeFrequenzHz);
   
-      String response;
-      serializeJson(resultDoc, response);
-      request->send(200, "application/json", response);
+      sendeJson(request, resultDoc);
     });
 
     server.on("/play", HTTP_POST, [](AsyncWebServerRequest *request) {
-    if (kanalDaten.empty()) {
+    // Armierte Wiedergabe (auch Szenario) sofort freigeben
+    if (wiedergabeZustand() != WiedergabeZustand::BEREIT && anzahlAktiverKanaele() == 0) {
         request->send(400, "text/plain", "❌ Keine Kanaldaten geladen. Bitte zuerst Datei hochladen und /processFiles aufrufen.");
         return;
     }
-    startAbspielTask();
+    if (!starteWiedergabe()) {
+        request->send(409, "text/plain", "Wiedergabe läuft bereits");
+        return;
+    }
     request->send(200, "text/plain", "Wiedergabe gestartet");
 });
 
+    // Bereitet die Wiedergabe vor; der folgende /play startet ohne Rechenaufwand
+    server.on("/arm", HTTP_POST, [](AsyncWebServerRequest *request) {
+        if (anzahlAktiverKanaele() == 0) {
+            request->send(400, "text/plain", "❌ Keine Kanaldaten geladen.");
+            return;
+        }
+        if (!armiereWiedergabe()) {
+            request->send(409, "text/plain", "Wiedergabe bereits armiert oder aktiv");
+            return;
+        }
+        request->send(200, "text/plain", "Wiedergabe armiert");
+    });
+
+    server.on("/stop", HTTP_POST, [](AsyncWebServerRequest *request) {
+        stoppeWiedergabe();
+        request->send(200, "text/plain", "Wiedergabe wird beendet");
+    });
+
+    server.on("/status", HTTP_GET, [](AsyncWebServerRequest *request) {
+        StartLatenz latenz = holeStartLatenz();
+        JsonDocument doc;
+        doc["state"] = wiedergabeZustandAlsText(wiedergabeZustand());
+        doc["startLatencyUs"] = latenz.letzteUs;
+        doc["coldStart"] = latenz.kaltstart;
+        doc["maxArmedStartLatencyUs"] = latenz.maxArmiertUs;
+        doc["starts"] = latenz.anzahl;
+        doc["rateHz"] = aktuelleAusgabeFrequenz();
+        sendeJson(request, doc);
+    });
+
+
+    // Erwartet {"name":"szenario.json"} (zuvor über /upload abgelegt), Aufbau siehe Szenario.hpp
+    server.on("/scenario", HTTP_POST, [](AsyncWebServerRequest *request){
+        // Antwort erfolgt im Body-Handler
+    }, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, data, len);
+        if (err) {
+            request->send(400, "text/plain", "Ungültiges JSON: " + String(err.c_str()));
+            return;
+        }
+        if (wiedergabeAktiv() || szenarioAktiv()) {
+            request->send(409, "text/plain", "Wiedergabe läuft, zuerst /stop");
+            return;
+        }
+        String fehler;
+        if (!starteSzenario("/" + String(doc["name"] | ""), fehler)) {
+            request->send(400, "text/plain", "❌ " + fehler);
+            return;
+        }
+        request->send(200, "text/plain", "Szenario gestartet");
+    });
+
+    server.on("/scenario", HTTP_GET, [](AsyncWebServerRequest *request) {
+        SzenarioStatus st = holeSzenarioStatus();
+        JsonDocument doc;
+        doc["running"] = st.laeuft;
+        doc["segments"] = st.segmentAnzahl;
+        doc["segment"] = st.aktuellesSegment;
+        doc["loops"] = st.durchlaeufe;
+        doc["underruns"] = st.unterlaeufe;
+        sendeJson(request, doc);
+    });
+
+    server.on("/stopScenario", HTTP_POST, [](AsyncWebServerRequest *request) {
+        stoppeSzenario();
+        request->send(200, "text/plain", "Szenario wird beendet");
+    });
+
+    // Kern, Priorität, freier Stack und CPU-Anteil seit der letzten Abfrage pro Task
+    server.on("/tasks", HTTP_GET, [](AsyncWebServerRequest *request) {
+        static TaskInfo tasks[TASK_INFO_MAX];
+        size_t anzahl = erfasseTasks(tasks, TASK_INFO_MAX);
+        JsonDocument doc;
+        JsonArray liste = doc["tasks"].to<JsonArray>();
+        for (size_t i = 0; i < anzahl; ++i) {
+            JsonObject t = liste.add<JsonObject>();
+            t["name"] = tasks[i].name;
+            t["core"] = tasks[i].core;
+            t["priority"] = tasks[i].prioritaet;
+            t["stackFreeBytes"] = tasks[i].stackFreiBytes;
+            if (tasks[i].cpuProzent >= 0.0f) t["cpuPercent"] = tasks[i].cpuProzent;
+        }
+        sendeJson(request, doc);
+    });
+
+    server.on("/boot", HTTP_GET, [](AsyncWebServerRequest *request) {
+        BootPhase phasen[BOOT_PHASEN_MAX];
+        size_t anzahl = leseBootZeitlinie(phasen, BOOT_PHASEN_MAX);
+        JsonDocument doc;
+        JsonArray liste = doc["phases"].to<JsonArray>();
+        for (size_t i = 0; i < anzahl; ++i) {
+            JsonObject p = liste.add<JsonObject>();
+            p["name"] = phasen[i].name;
+            p["core"] = phasen[i].core;
+            p["startUs"] = phasen[i].beginnUs;
+            p["durationUs"] = phasen[i].dauerUs;
+        }
+        JsonObject bereit = doc["readyUs"].to<JsonObject>();
+        for (uint8_t i = 0; i < BOOT_ANZAHL_TEILE; ++i) bereit[bootTeilName(i)] = bootBereitUs(i);
+        doc["firstSampleUs"] = bootErsteAusgabeUs();
+        sendeJson(request, doc);
+    });
+
+    server.on("/autostart", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["enabled"] = autostartAktiv();
+        doc["imageBytes"] = groesseWiedergabebild();
+        sendeJson(request, doc);
+    });
+
+    server.on("/autostart", HTTP_POST, [](AsyncWebServerRequest *request){
+        // Antwort erfolgt im Body-Handler
+    }, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, data, len);
+        if (err || !doc["enabled"].is<bool>()) {
+            request->send(400, "text/plain", "Erwartet: {\"enabled\": true|false}");
+            return;
+        }
+        setzeAutostart(doc["enabled"].as<bool>());
+        request->send(200, "text/plain", "OK");
+    });
+
+    server.on("/trigger", HTTP_GET, [](AsyncWebServerRequest *request) {
+        TriggerEinstellung e = holeTriggerEinstellung();
+        TriggerStatistik st = holeTriggerStatistik();
+        JsonDocument doc;
+        doc["pin"] = TRIGGER_PIN;
+        doc["action"] = triggerAktionAlsText(e.aktion);
+        doc["edge"] = triggerFlankeAlsText(e.flanke);
+        doc["debounceUs"] = e.entprellUs;
+        doc["triggers"] = st.ausloesungen;
+        doc["rejected"] = st.verworfen;
+        doc["minLatencyUs"] = st.minLatenzUs;
+        doc["maxLatencyUs"] = st.maxLatenzUs;
+        doc["avgLatencyUs"] = st.latenzAnzahl ? (uint32_t)(st.summeLatenzUs / st.latenzAnzahl) : 0;
+        sendeJson(request, doc);
+    });
+
+    // Erwartet {"action":"start"|"stop"|"toggle"|"advance"|"off","edge":"rising"|"falling"|"both","debounceUs":2000}
+    server.on("/trigger", HTTP_POST, [](AsyncWebServerRequest *request){
+        // Antwort erfolgt im Body-Handler
+    }, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, data, len);
+        if (err) {
+            request->send(400, "text/plain", "Ungültiges JSON: " + String(err.c_str()));
+            return;
+        }
+        Konfiguration k = konfiguration();
+        if (doc["action"].is<const char*>()) k.trigger.aktion = triggerAktionAusText(doc["action"]);
+        if (doc["edge"].is<const char*>()) k.trigger.flanke = triggerFlankeAusText(doc["edge"]);
+        k.trigger.entprellUs = doc["debounceUs"] | k.trigger.entprellUs;
+        String fehler;
+        if (!aendereKonfiguration(k, fehler)) {
+            request->send(400, "text/plain", fehler);
+            return;
+        }
+        setzeTriggerEinstellung(k.trigger);
+        request->send(200, "text/plain", "OK");
+    });
+
+    server.on("/sync", HTTP_GET, [](AsyncWebServerRequest *request) {
+        SyncStatistik st = holeSyncStatistik();
+        JsonDocument doc;
+        doc["mode"] = syncModusAlsText(syncModus());
+        doc["pin"] = SYNC_PIN;
+        doc["pulses"] = st.pulse;
+        doc["timeouts"] = st.ausfaelle;
+        doc["backlog"] = st.rueckstand;
+        doc["skipped"] = st.ausgelassen;
+        doc["held"] = st.gehalten;
+        doc["maxLatencyUs"] = st.maxLatenzUs;
+        doc["minPeriodUs"] = st.minPeriodeUs;
+        doc["maxPeriodUs"] = st.maxPeriodeUs;
+        sendeJson(request, doc);
+    });
+
+    // Erwartet {"mode":"master"|"slave"|"off"}; bleibt über Neustarts erhalten
+    server.on("/sync", HTTP_POST, [](AsyncWebServerRequest *request){
+        // Antwort erfolgt im Body-Handler
+    }, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, data, len);
+        if (err) {
+            request->send(400, "text/plain", "Ungültiges JSON: " + String(err.c_str()));
+            return;
+        }
+        KanalTabellenSperre sperre;
+        if (!sperre.gesperrt) {
+            request->send(409, "text/plain", "Wiedergabe läuft");
+            return;
+        }
+        Konfiguration k = konfiguration();
+        k.syncModus = syncModusAusText(doc["mode"] | "off");
+        String fehler;
+        if (!aendereKonfiguration(k, fehler)) {
+            request->send(400, "text/plain", fehler);
+            return;
+        }
+        setzeSyncModus(k.syncModus);
+        request->send(200, "text/plain", "OK");
+    });
+
+    // Protokoll der zuletzt ausgegebenen Marker (älteste zuerst)
+    server.on("/markers", HTTP_GET, [](AsyncWebServerRequest *request) {
+        static MarkerEreignis ereignisse[MARKER_LOG_GROESSE];
+        MarkerStatistik stat;
+        size_t anzahl = leseMarkerProtokoll(ereignisse, MARKER_LOG_GROESSE, stat);
+        JsonDocument doc;
+        doc["count"] = stat.anzahl;
+        doc["maxLatencyNs"] = stat.maxLatenzNs;
+        doc["avgLatencyNs"] = stat.anzahl ? (uint32_t)(stat.summeLatenzNs / stat.anzahl) : 0;
+        JsonArray liste = doc["events"].to<JsonArray>();
+        for (size_t i = 0; i < anzahl; ++i) {
+            JsonObject e = liste.add<JsonObject>();
+            e["sample"] = ereignisse[i].sample;
+            e["timeUs"] = ereignisse[i].zeitUs;
+            e["latencyNs"] = ereignisse[i].latenzNs;
+            e["channel"] = kanalName(ereignisse[i].kanal);
+            e["text"] = ereignisse[i].text;
+        }
+        sendeJson(request, doc);
+    });
 
-    server.serveStatic("/script.js", SPIFFS, "/script.js");
-  
     server.on("/resetChannels", HTTP_POST, [](AsyncWebServerRequest *request) {
-        kanalDaten.clear();
-        // Optional: weitere Arrays zurücksetzen, falls benötigt
-        // uploadedFiles.clear();
-        // activeUploads.clear();
+        {
+            KanalTabellenSperre sperre;
+            if (!sperre.gesperrt) {
+                request->send(409, "text/plain", "Wiedergabe läuft, zuerst /stop");
+                return;
+            }
+            for (Kanal& kanal : kanalTabelle) kanal = Kanal();
+        }
+        loescheWiedergabebild();
         request->send(200, "text/plain", "Kanaldaten zurückgesetzt");
     });
   
     server.on("/getFrequency", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "application/json", "{\"frequency\":" + String(ausgabeFrequenzHz) + "}");
+        JsonDocument doc;
+        doc["frequency"] = ausgabeFrequenzHz;
+        doc["currentHz"] = aktuelleAusgabeFrequenz();
+        sendeJson(request, doc);
     });
 
     server.on("/setFrequency", HTTP_POST, [](AsyncWebServerRequest *request){
@@ -273,7 +894,6 @@ void setupRoutes(AsyncWebServer& server) {
     [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
         String body((char*)data, len);
         if (body.length() == 0) {
-            request->send(400, "text/plain", "Kein JSON empfangen");
             request->send(400, "text/plain", "Kein JSON empfangen");
             return;
         }
@@ -287,17 +907,270 @@ void setupRoutes(AsyncWebServer& server) {
             request->send(400, "text/plain", "Feld 'frequency' fehlt");
             return;
         }
-        int freq = doc["frequency"];
-        if (freq >= 1 && freq <= 1000) {
-            ausgabeFrequenzHz = freq;
-            speichereFrequenzInDatei(freq);
+        // Gebrochene Frequenzen erlaubt; "ramp" (s) gleitet eine laufende Wiedergabe über
+        float freq = doc["frequency"];
+        float rampe = doc["ramp"] | 0.0f;
+        Konfiguration k = konfiguration();
+        k.frequenzHz = freq;
+        String fehler;
+        if (!isfinite(rampe) || rampe < 0.0f) {
+            request->send(400, "text/plain", "Ungültige Rampe");
+        } else if (aendereKonfiguration(k, fehler)) {
+            setzeAusgabeFrequenz(freq, rampe);
             request->send(200, "text/plain", "OK");
         } else {
-            request->send(400, "text/plain", "Ungültige Frequenz");
+            request->send(400, "text/plain", fehler);
         }
     }
 );
 
+    server.on("/filter", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["oversampling"] = filterEinstellung.faktor;
+        doc["taps"] = filterEinstellung.tapsProPhase;
+        doc["cutoff"] = filterEinstellung.grenzfrequenz;
+        sendeJson(request, doc);
+    });
+
+    // Erwartet {"oversampling":4,"taps":8,"cutoff":0.9}; wirkt ab dem nächsten Abspielstart
+    server.on("/filter", HTTP_POST, [](AsyncWebServerRequest *request){
+        // Antwort erfolgt im Body-Handler
+    }, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, data, len);
+        if (err) {
+            request->send(400, "text/plain", "Ungültiges JSON: " + String(err.c_str()));
+            return;
+        }
+        FilterEinstellung e = filterEinstellung;
+        e.faktor = doc["oversampling"] | e.faktor;
+        e.tapsProPhase = doc["taps"] | e.tapsProPhase;
+        e.grenzfrequenz = doc["cutoff"] | e.grenzfrequenz;
+        e = begrenzeFilterEinstellung(e);
+        String fehler;
+        if (!ausgabetaktGueltig(konfiguration().frequenzHz, e, fehler)) {
+            request->send(400, "text/plain", fehler);
+            return;
+        }
+        filterEinstellung = e;
+        request->send(200, "text/plain", "OK");
+    });
+
+    server.on("/artifacts", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        JsonArray kanaele = doc["channels"].to<JsonArray>();
+        for (int kanal = 0; kanal < ANZAHL_KANAELE; ++kanal) {
+            JsonObject obj = kanaele.add<JsonObject>();
+            obj["channel"] = kanalName(kanal);
+            for (int t = 0; t < ANZAHL_ARTEFAKTTYPEN; ++t) {
+                const ArtefaktEinstellung& e = artefaktEinstellungen[kanal].typ[t];
+                JsonObject a = obj[artefaktName((ArtefaktTyp)t)].to<JsonObject>();
+                a["enabled"] = e.aktiv;
+                a["amplitude"] = e.amplitudeMv;
+                if (t == NETZBRUMMEN) {
+                    a["frequency"] = e.frequenzHz;
+                } else {
+                    a["interval"] = e.intervallS;
+                    a["duration"] = e.dauerS;
+                    a["random"] = e.zufaellig;
+                }
+            }
+        }
+        sendeJson(request, doc);
+    });
+
+    // Erwartet {"channel":"CH_A","hum":{"enabled":true,"amplitude":0.02,"frequency":50},
+    //           "blink":{"enabled":true,"amplitude":0.1,"interval":4,"duration":0.4,"random":true}, ...}
+    // Nicht angegebene Artefakte bleiben unverändert; wirkt ab dem nächsten Abspielstart
+    server.on("/artifacts", HTTP_POST, [](AsyncWebServerRequest *request){
+        // Antwort erfolgt im Body-Handler
+    }, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, data, len);
+        if (err) {
+            request->send(400, "text/plain", "Ungültiges JSON: " + String(err.c_str()));
+            return;
+        }
+        int kanal = kanalIndexAusName(doc["channel"] | "");
+        if (kanal < 0) {
+            request->send(400, "text/plain", "Ungültiger Kanal");
+            return;
+        }
+        KanalArtefakte neu = artefaktEinstellungen[kanal];
+        for (int t = 0; t < ANZAHL_ARTEFAKTTYPEN; ++t) {
+            JsonObject a = doc[artefaktName((ArtefaktTyp)t)];
+            if (a.isNull()) continue;
+            ArtefaktEinstellung& e = neu.typ[t];
+            e.aktiv = a["enabled"] | e.aktiv;
+            e.amplitudeMv = a["amplitude"] | e.amplitudeMv;
+            e.frequenzHz = a["frequency"] | e.frequenzHz;
+            e.intervallS = a["interval"] | e.intervallS;
+            e.dauerS = a["duration"] | e.dauerS;
+            e.zufaellig = a["random"] | e.zufaellig;
+            if (!artefaktEinstellungGueltig(e)) {
+                request->send(400, "text/plain", "Ungültige Einstellung für " + String(artefaktName((ArtefaktTyp)t)));
+                return;
+            }
+        }
+        // Brummen entsteht im Ausgabetakt (Quelltakt * Überabtastung)
+        const ArtefaktEinstellung& brummen = neu.typ[NETZBRUMMEN];
+        const float ausgaberate = konfiguration().frequenzHz * (filterEinstellung.aktiv() ? filterEinstellung.faktor : 1);
+        if (brummen.aktiv && !brummenDarstellbar(brummen.frequenzHz, ausgaberate)) {
+            request->send(400, "text/plain", "hum: frequency muss unter " + String(ausgaberate / 2.0f, 1) +
+                          " Hz liegen (halber Ausgabetakt, ggf. /filter mit Überabtastung)");
+            return;
+        }
+        artefaktEinstellungen[kanal] = neu;
+        request->send(200, "text/plain", "OK");
+    });
+
+    server.on("/channels", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["count"] = ANZAHL_KANAELE;
+        JsonArray namen = doc["names"].to<JsonArray>();
+        for (int kanal = 0; kanal < ANZAHL_KANAELE; ++kanal) namen.add(kanalName(kanal));
+        sendeJson(request, doc);
+    });
+
+    // Gesamte Konfiguration einschließlich Kalibrierung
+    server.on("/config", HTTP_GET, [](AsyncWebServerRequest *request) {
+        const Konfiguration& k = konfiguration();
+        JsonDocument doc;
+        doc["frequency"] = k.frequenzHz;
+        JsonObject bereich = doc["range"].to<JsonObject>();
+        bereich["mode"] = bereichsModusAlsText(k.bereichsModus);
+        bereich["min"] = k.minMv;
+        bereich["max"] = k.maxMv;
+        doc["autostart"] = k.autostart;
+        JsonObject prio = doc["priorities"].to<JsonObject>();
+        prio["playback"] = k.abspielPrio;
+        prio["preload"] = k.vorladePrio;
+        JsonObject zuordnung = doc["channelMap"].to<JsonObject>();
+        for (uint8_t i = 0; i < ANZAHL_KANAELE; ++i) zuordnung[kanalName(i)] = kanalName(k.kanalZuordnung[i]);
+        doc["sync"] = syncModusAlsText(k.syncModus);
+        JsonObject trigger = doc["trigger"].to<JsonObject>();
+        trigger["action"] = triggerAktionAlsText(k.trigger.aktion);
+        trigger["edge"] = triggerFlankeAlsText(k.trigger.flanke);
+        trigger["debounceUs"] = k.trigger.entprellUs;
+        JsonArray kalibrierung = doc["calibration"].to<JsonArray>();
+        for (int kanal = 0; kanal < ANZAHL_KANAELE; ++kanal) kalibrierungAlsJson(kanal, kalibrierung.add<JsonObject>());
+        doc["pending"] = konfigurationAusstehend();
+        sendeJson(request, doc);
+    });
+
+    // Nimmt beliebige Teile der GET-Antwort entgegen; fehlende Felder bleiben
+    server.on("/config", HTTP_POST, [](AsyncWebServerRequest *request){
+        // Antwort erfolgt im Body-Handler
+    }, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, data, len);
+        if (err) {
+            request->send(400, "text/plain", "Ungültiges JSON: " + String(err.c_str()));
+            return;
+        }
+        Konfiguration k = konfiguration();
+        k.frequenzHz = doc["frequency"] | k.frequenzHz;
+        if (doc["range"]["mode"].is<const char*>()) k.bereichsModus = bereichsModusAusText(doc["range"]["mode"]);
+        k.minMv = doc["range"]["min"] | k.minMv;
+        k.maxMv = doc["range"]["max"] | k.maxMv;
+        k.autostart = doc["autostart"] | k.autostart;
+        k.abspielPrio = doc["priorities"]["playback"] | k.abspielPrio;
+        k.vorladePrio = doc["priorities"]["preload"] | k.vorladePrio;
+        for (JsonPair p : doc["channelMap"].as<JsonObject>()) {
+            int quelle = kanalIndexAusName(p.key().c_str());
+            int ziel = kanalIndexAusName(p.value() | "");
+            if (quelle < 0 || ziel < 0) {
+                request->send(400, "text/plain", "channelMap: unbekannter Kanal");
+                return;
+            }
+            k.kanalZuordnung[quelle] = ziel;
+        }
+        if (doc["sync"].is<const char*>()) k.syncModus = syncModusAusText(doc["sync"]);
+        if (doc["trigger"]["action"].is<const char*>()) k.trigger.aktion = triggerAktionAusText(doc["trigger"]["action"]);
+        if (doc["trigger"]["edge"].is<const char*>()) k.trigger.flanke = triggerFlankeAusText(doc["trigger"]["edge"]);
+        k.trigger.entprellUs = doc["trigger"]["debounceUs"] | k.trigger.entprellUs;
+        // Sync-Modus, Zuordnung und Kalibriertabellen bleiben während einer
+        // Wiedergabe fest (der Abspiel-Task liest sie ohne Sperre)
+        const bool syncGeaendert = k.syncModus != konfiguration().syncModus;
+        const bool zuordnungGeaendert = memcmp(k.kanalZuordnung, konfiguration().kanalZuordnung,
+                                               sizeof(k.kanalZuordnung)) != 0;
+        const bool kalibrierung = doc["calibration"].size() > 0;
+        const bool sperren = syncGeaendert || zuordnungGeaendert || kalibrierung;
+        KanalTabellenSperre sperre(sperren);
+        if (sperren && !sperre.gesperrt) {
+            request->send(409, "text/plain", syncGeaendert ? "sync: Wiedergabe läuft"
+                                             : zuordnungGeaendert ? "channelMap: Wiedergabe läuft"
+                                             : "calibration: Wiedergabe läuft");
+            return;
+        }
+        // Erst alles prüfen, dann übernehmen: ein Fehler ändert nichts
+        String fehler;
+        std::vector<std::pair<int, KanalKalibrierung>> kalibrierungen;
+        for (JsonObjectConst kal : doc["calibration"].as<JsonArrayConst>()) {
+            int kanal = -1;
+            KanalKalibrierung kk;
+            if (!kalibrierungAusJson(kal, kanal, kk, fehler)) {
+                request->send(400, "text/plain", "calibration: " + fehler);
+                return;
+            }
+            kalibrierungen.emplace_back(kanal, kk);
+        }
+        if (!aendereKonfiguration(k, fehler)) {
+            request->send(400, "text/plain", fehler);
+            return;
+        }
+        if (k.frequenzHz != ausgabeFrequenzHz) setzeAusgabeFrequenz(k.frequenzHz);
+        if (k.syncModus != syncModus()) setzeSyncModus(k.syncModus);
+        if (k.trigger != holeTriggerEinstellung()) setzeTriggerEinstellung(k.trigger);
+        for (const auto& [kanal, kk] : kalibrierungen) {
+            if (!setzeKalibrierung(kanal, kk)) {
+                request->send(500, "text/plain", "calibration: Speichern fehlgeschlagen");
+                return;
+            }
+        }
+        request->send(200, "text/plain", "OK");
+    });
+
+    server.on("/calibration", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        JsonArray kanaele = doc["channels"].to<JsonArray>();
+        for (int kanal = 0; kanal < ANZAHL_KANAELE; ++kanal) kalibrierungAlsJson(kanal, kanaele.add<JsonObject>());
+        sendeJson(request, doc);
+    });
+
+    // Erwartet {"channel":"CH_A","gain":1.0,"offset":0.0,"points":[[code,korrektur],...]}
+    server.on("/calibration", HTTP_POST, [](AsyncWebServerRequest *request){
+        // Antwort erfolgt im Body-Handler
+    }, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, data, len);
+        if (err) {
+            request->send(400, "text/plain", "Ungültiges JSON: " + String(err.c_str()));
+            return;
+        }
+        KanalTabellenSperre sperre;
+        if (!sperre.gesperrt) {
+            request->send(409, "text/plain", "Wiedergabe läuft");
+            return;
+        }
+        String fehler;
+        int kanal = -1;
+        KanalKalibrierung k;
+        if (!kalibrierungAusJson(doc.as<JsonObjectConst>(), kanal, k, fehler)) {
+            request->send(400, "text/plain", fehler);
+            return;
+        }
+        if (!setzeKalibrierung(kanal, k)) {
+            request->send(500, "text/plain", "Speichern fehlgeschlagen");
+            return;
+        }
+        request->send(200, "text/plain", "OK");
+    });
+
     server.begin();
     Serial.println("Webserver gestartet.");
   }
\ No newline at end of file
@@ -15,13 +15,55 @@
 #include "Global_Var.hpp"
 #include "PinMapping.hpp"
 #include "Spannungswandlung.hpp"
+#include "Kompression.hpp"
+#include "Kalibrierung.hpp"
+#include "Szenario.hpp"
+#include "Marker.hpp"
+#include "Synchronisation.hpp"
+#include "Trigger.hpp"
+#include "TaskTopologie.hpp"
+#include "WebOberflaeche.hpp"
+#include "Bootablauf.hpp"
+#include "Wiedergabebild.hpp"
+#include "Heapwaechter.hpp"
+#include "Vorschau.hpp"
+
+// Endung der komprimierten Kanal-Caches im SPIFFS
+#define CACHE_ENDUNG ".eegz"
+
+// Rückmeldung zum Laden einer Kanaldatei
+struct SignalLadeInfo {
+  bool ausCache = false;   // aus der .eegz-Fassung gelesen
+  size_t textBytes = 0;    // Größe der geparsten Textdatei
+  size_t cacheBytes = 0;   // Größe des neu angelegten Caches (0 = keiner)
+};
 
 // Funktionsprototypen
 void setupWebServer();
 void setupRoutes(AsyncWebServer& server);
 
-std::vector<float> extractNumbersRegex(const String &content);
 String generateUniqueFileName(const String& baseName);
-String getUploadedFilesList();
+String cachePfad(const String& textPfad);
+bool ladeKanalCache(const String& pfad, std::vector<float>& werte);
+bool speichereKanalCache(const String& pfad, const std::vector<float>& werte, size_t& bytes);
+// Lädt eine Kanaldatei über ihren Cache, legt den Cache bei Bedarf an
+bool ladeSignaldatei(const String& pfad, std::vector<float>& werte, SignalLadeInfo& info);
+// Textdatei oder (nach Upload mit convert=only) nur ihre .eegz-Fassung vorhanden
+bool signaldateiVorhanden(const String& pfad);
+// Dateinamen für /getFiles (Caches nur anstelle einer fehlenden Textdatei)
+void sammleDateiliste(JsonArray dateien);
+
+// Platz für einen Upload aus activeUploads; nullptr, wenn alle belegt sind
+ActiveUpload* belegeUpload(AsyncWebServerRequest* request);
+ActiveUpload* findeUpload(AsyncWebServerRequest* request);
+// Schließt die Datei und gibt Platz und Zahlenpuffer frei
+void gebeUploadFrei(ActiveUpload& upload);
+
+// Serialisiert direkt in die Antwort (eine Anforderung in passender Größe statt
+// eines wachsenden String)
+void sendeJson(AsyncWebServerRequest* request, const JsonDocument& doc, int code = 200);
+
+// Zahlen je Datei in der Antwort von /processFiles (Rest nur gezählt)
+#define VERARBEITUNG_VORSCHAU_ZAHLEN  32
 
 #endif // SERVER_HPP
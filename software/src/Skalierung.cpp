@@ -0,0 +1,152 @@
+#include "Skalierung.hpp"
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef ESP_PLATFORM
+#include <sdkconfig.h>
+#endif
+
+// Größter zulässiger Betrag eines Bereichs
+#define GRENZE_MV  10000.0f
+
+KanalSkalierung berechneSkalierung(BereichsModus modus, float minMv, float maxMv) {
+  KanalSkalierung s;
+  s.modus = modus;
+  if (modus == BereichsModus::FEST || !isfinite(minMv) || !isfinite(maxMv)) {
+    minMv = STANDARD_MIN_MV;
+    maxMv = STANDARD_MAX_MV;
+  }
+  if (minMv > maxMv) {
+    float t = minMv;
+    minMv = maxMv;
+    maxMv = t;
+  }
+  if (minMv < -GRENZE_MV) minMv = -GRENZE_MV;
+  if (maxMv > GRENZE_MV) maxMv = GRENZE_MV;
+
+  // Konstantes Signal: auf 1 µV Spanne aufweiten (Sicherheitsabfrage gegen Division durch 0)
+  if (maxMv - minMv < 0.001f) maxMv = minMv + 0.001f;
+  s.minMv = minMv;
+  s.maxMv = maxMv;
+  s.codesProMv = (float)(DAC_MAX_CODE / ((double)maxMv - (double)minMv));
+  s.ruhe = normiereMv(0.0f, s);
+  return s;
+}
+
+bool bestimmeBereich(const float* werte, size_t anzahl, float& minMv, float& maxMv) {
+  if (anzahl == 0) return false;
+  minMv = werte[0];
+  maxMv = werte[0];
+  for (size_t i = 1; i < anzahl; ++i) {
+    if (werte[i] < minMv) minMv = werte[i];
+    if (werte[i] > maxMv) maxMv = werte[i];
+  }
+  return true;
+}
+
+BereichsModus bereichsModusAusText(const char* text) {
+  if (text == nullptr) return BereichsModus::FEST;
+  if (strcmp(text, "auto") == 0) return BereichsModus::AUTO;
+  if (strcmp(text, "user") == 0) return BereichsModus::BENUTZER;
+  return BereichsModus::FEST;
+}
+
+const char* bereichsModusAlsText(BereichsModus modus) {
+  switch (modus) {
+    case BereichsModus::AUTO:     return "auto";
+    case BereichsModus::BENUTZER: return "user";
+    default:                      return "fixed";
+  }
+}
+
+void normiereBlock(const float* mv, size_t anzahl, const KanalSkalierung& s, Q15* ziel) {
+  for (size_t i = 0; i < anzahl; ++i) ziel[i] = normiereMv(mv[i], s);
+}
+
+Q15 amplitudeAlsQ15(float mv, const KanalSkalierung& s) {
+  // Ein Q15-Schritt entspricht 1/16 Code
+  return Q15::ausFloat(mv * s.codesProMv * 16.0f / 32768.0f);
+}
+
+void konvertiereBlockSkalar(const Q15* samples, size_t anzahl, const uint16_t* lut, uint16_t* codes) {
+  if (lut == nullptr) {
+    for (size_t i = 0; i < anzahl; ++i) codes[i] = codeAusQ15(samples[i]);
+    return;
+  }
+  size_t i = 0;
+  // Vierfach entrollt: unabhängige Ketten füllen die Pipeline
+  for (; i + 4 <= anzahl; i += 4) {
+    uint16_t c0 = codeAusQ15(samples[i]);
+    uint16_t c1 = codeAusQ15(samples[i + 1]);
+    uint16_t c2 = codeAusQ15(samples[i + 2]);
+    uint16_t c3 = codeAusQ15(samples[i + 3]);
+    codes[i] = lut[c0];
+    codes[i + 1] = lut[c1];
+    codes[i + 2] = lut[c2];
+    codes[i + 3] = lut[c3];
+  }
+  for (; i < anzahl; ++i) {
+    codes[i] = lut[codeAusQ15(samples[i])];
+  }
+}
+
+#ifdef __SSE2__
+static_assert(sizeof(Q15) == sizeof(int16_t), "Q15 muss dicht gepackt sein");
+
+// Acht Samples je Befehl: roh + 32768 als Vorzeichenumkehr, + 8 mit Sättigung,
+// >> 4. Die Sättigung bei 65535 ersetzt die Begrenzung auf DAC_MAX_CODE
+// (65535 >> 4 = 4095), daher bitgleich zu codeAusQ15().
+void konvertiereBlock(const Q15* samples, size_t anzahl, const uint16_t* lut, uint16_t* codes) {
+  const __m128i vorzeichen = _mm_set1_epi16((int16_t)0x8000);
+  const __m128i rundung = _mm_set1_epi16(8);
+  size_t i = 0;
+  for (; i + 8 <= anzahl; i += 8) {
+    __m128i q = _mm_loadu_si128((const __m128i*)&samples[i]);
+    __m128i c = _mm_srli_epi16(_mm_adds_epu16(_mm_xor_si128(q, vorzeichen), rundung), 4);
+    _mm_storeu_si128((__m128i*)&codes[i], c);
+  }
+  for (; i < anzahl; ++i) codes[i] = codeAusQ15(samples[i]);
+  if (lut != nullptr) {
+    for (size_t j = 0; j < anzahl; ++j) codes[j] = lut[codes[j]];
+  }
+}
+#elif defined(CONFIG_IDF_TARGET_ESP32S3)
+static_assert(sizeof(Q15) == sizeof(int16_t), "Q15 muss dicht gepackt sein");
+
+// KonvertierungPie.S: acht Samples je Befehlsfolge, Ziel auf 16 Byte ausgerichtet
+extern "C" void konvertiereQ15Pie(const Q15* samples, uint16_t* codes, size_t vektoren,
+                                  const int16_t* konstanten);
+
+alignas(16) static const int16_t pieKonstanten[24] = {
+  8, 8, 8, 8, 8, 8, 8, 8,
+  (int16_t)0x8000, (int16_t)0x8000, (int16_t)0x8000, (int16_t)0x8000,
+  (int16_t)0x8000, (int16_t)0x8000, (int16_t)0x8000, (int16_t)0x8000,
+  0x0FFF, 0x0FFF, 0x0FFF, 0x0FFF, 0x0FFF, 0x0FFF, 0x0FFF, 0x0FFF,
+};
+
+// Nur aus Tasks mit fester Kernbindung aufrufen (PIE-Register sind
+// Koprozessor-Kontext); der Abspiel-Task ist an ABSPIEL_TASK_CORE gebunden.
+// Die Kalibriertabelle bleibt ein skalarer Zugriff je Sample (PIE hat keine
+// Gather-Ladebefehle).
+void konvertiereBlock(const Q15* samples, size_t anzahl, const uint16_t* lut, uint16_t* codes) {
+  alignas(16) uint16_t roh[KONVERTIERUNG_BLOCK];
+  size_t i = 0;
+  while (anzahl - i >= 8) {
+    size_t n = (anzahl - i) & ~(size_t)7;
+    if (n > KONVERTIERUNG_BLOCK) n = KONVERTIERUNG_BLOCK;
+    konvertiereQ15Pie(&samples[i], roh, n / 8, pieKonstanten);
+    if (lut != nullptr) {
+      for (size_t j = 0; j < n; ++j) codes[i + j] = lut[roh[j]];
+    } else {
+      memcpy(&codes[i], roh, n * sizeof(uint16_t));
+    }
+    i += n;
+  }
+  for (; i < anzahl; ++i) codes[i] = lut ? lut[codeAusQ15(samples[i])] : codeAusQ15(samples[i]);
+}
+#else
+void konvertiereBlock(const Q15* samples, size_t anzahl, const uint16_t* lut, uint16_t* codes) {
+  konvertiereBlockSkalar(samples, anzahl, lut, codes);
+}
+#endif
@@ -0,0 +1,82 @@
+#ifndef SKALIERUNG_HPP
+#define SKALIERUNG_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "Festkomma.hpp"
+
+// Standardbereich, wenn nichts anderes gewählt ist (mV)
+#define STANDARD_MIN_MV  -150.0f
+#define STANDARD_MAX_MV   150.0f
+
+#define DAC_MAX_CODE      4095
+
+// Wie der Amplitudenbereich eines Kanals bestimmt wird
+enum class BereichsModus : uint8_t {
+  FEST,       // Standardbereich ±150 mV
+  AUTO,       // Minimum/Maximum der geladenen Daten
+  BENUTZER    // vom Benutzer vorgegebenes Minimum/Maximum
+};
+
+// Samples liegen nach dem Laden als Q15 relativ zum Kanalbereich vor:
+//   roh + 32768 = 16 * (mV - minMv) * codesProMv   (DAC-Code mit 4 Bruchbits)
+// -1 entspricht minMv, +1 (bis auf 1/16 Code) maxMv. Damit rechnet der
+// Abspielpfad nur noch mit Ganzzahlen; float kommt nur beim Laden vor.
+// Ein fester µV-Festkommafaktor reicht für Bereiche unter 1 mV nicht aus,
+// daher wird der Kehrwert der Spanne einmalig als float vorberechnet.
+struct KanalSkalierung {
+  BereichsModus modus = BereichsModus::FEST;
+  float minMv = STANDARD_MIN_MV;
+  float maxMv = STANDARD_MAX_MV;
+  float codesProMv = DAC_MAX_CODE / (STANDARD_MAX_MV - STANDARD_MIN_MV);
+  Q15 ruhe = Q15::ausRoh(DAC_MAX_CODE * 8 - 32768);   // 0 mV, hier Bereichsmitte
+};
+
+// Samples pro Block in konvertiereBlock()
+#define KONVERTIERUNG_BLOCK  32
+
+// Legt Bereich und Festkomma-Faktor fest (einmalig beim Laden)
+KanalSkalierung berechneSkalierung(BereichsModus modus, float minMv, float maxMv);
+
+// Minimum und Maximum der Daten; false bei leerem Vektor
+bool bestimmeBereich(const float* werte, size_t anzahl, float& minMv, float& maxMv);
+
+// "fixed", "auto", "user"
+BereichsModus bereichsModusAusText(const char* text);
+const char* bereichsModusAlsText(BereichsModus modus);
+
+// Beim Laden: mV -> Q15 im Kanalbereich, vorab auf [minMv, maxMv] begrenzt
+// (NaN landet über fmaxf auf minMv)
+static inline Q15 normiereMv(float mv, const KanalSkalierung& s) {
+  float begrenzt = fminf(fmaxf(mv, s.minMv), s.maxMv);
+  int32_t u = (int32_t)((begrenzt - s.minMv) * (s.codesProMv * 16.0f) + 0.5f);
+  if (u > DAC_MAX_CODE * 16) u = DAC_MAX_CODE * 16;
+  return Q15::ausRoh((int16_t)(u - 32768));
+}
+
+void normiereBlock(const float* mv, size_t anzahl, const KanalSkalierung& s, Q15* ziel);
+
+// Amplitude in mV als Q15-Anteil des Kanalbereichs (für den Sinusgenerator)
+Q15 amplitudeAlsQ15(float mv, const KanalSkalierung& s);
+
+// Heißer Pfad: Q15 -> unkalibrierter DAC-Code, nur Addition und Shift.
+// Gegenüber der direkten float-Rechnung round((mV - minMv) * codesProMv)
+// weicht der Code um höchstens 1 LSB ab, und nur wenn der exakte Wert weniger
+// als 1/32 LSB neben einer Rundungsgrenze liegt.
+static inline uint16_t codeAusQ15(Q15 q) {
+  uint32_t code = ((uint32_t)(q.roh + 32768) + 8) >> 4;
+  return (code > DAC_MAX_CODE) ? DAC_MAX_CODE : (uint16_t)code;
+}
+
+// Blockweise Umrechnung Q15 -> kalibrierter DAC-Code in einem Durchlauf
+// (Sättigung, Kalibriertabelle). Liefert exakt dieselben Codes wie
+// codeAusQ15() gefolgt von lut[code]; lut = nullptr lässt die Kalibrierung
+// weg (z. B. wenn danach noch gefiltert wird).
+// Acht Samples je Befehl: auf dem Host mit SSE2, auf dem ESP32-S3 mit den
+// PIE-Befehlen (KonvertierungPie.S); sonst die skalare Fassung.
+void konvertiereBlock(const Q15* samples, size_t anzahl, const uint16_t* lut, uint16_t* codes);
+// Skalare Fassung, Referenz für die Host-Tests
+void konvertiereBlockSkalar(const Q15* samples, size_t anzahl, const uint16_t* lut, uint16_t* codes);
+
+#endif // SKALIERUNG_HPP
@@ -1,163 +1,789 @@
 #include "./Spannungswandlung.hpp"
 #include "Global_Var.hpp"
 #include "PinMapping.hpp"
+#include "Kalibrierung.hpp"
+#include "DacRouting.hpp"
+#include "Rekonstruktion.hpp"
+#include "Artefakte.hpp"
+#include "Szenario.hpp"
+#include "Synchronisation.hpp"
+#include "Trigger.hpp"
+#include "TaskTopologie.hpp"
+#include "Bootablauf.hpp"
+#include "Konfiguration.hpp"
+#include "Heapwaechter.hpp"
+#include "Blockablauf.hpp"
+#include "Takt.hpp"
+#include "KanalZeitachse.hpp"
 #include <Arduino.h>
+#include <algorithm>
+#include <esp_timer.h>
 
-void ausgabe(char Channel, uint16_t Data) {
-    //Serial.printf("Ausgabe auf Kanal %c: %u\n", Channel, Data);
-    Data &= 0x0FFF; // Nur untere 12 Bit zulassen
-  
-    digitalWrite(R_W, LOW);        // Schreiben aktivieren
-    digitalWrite(Load_Data, LOW);  // LDAC aktivieren
-  
-  
-    // Adressleitungen A0, A1 setzen → DAC A–D
-    switch(Channel) {
-        case 'A':
-            digitalWrite(ADD0, LOW);     // A0
-            digitalWrite(ADD1, LOW);    // A1
-            break;
-        case 'B':
-            digitalWrite(ADD0, HIGH);    // A0
-            digitalWrite(ADD1, LOW);     // A1
-            break;
-        case 'C':
-            digitalWrite(ADD0, LOW);    // A0
-            digitalWrite(ADD1, HIGH);     // A1
-            break;
-        case 'D':
-            digitalWrite(ADD0, HIGH);     // A0
-            digitalWrite(ADD1, HIGH);    // A1
-            break;
-        default:
-            Serial.println("Ungültiger Kanal!"); // Ungültiger Kanal
-            return; // Funktion beenden
-    }
-  
-    // Datenleitungen setzen (12 Bit)
-    digitalWrite(DB0,  (Data >> 0)  & 0x01);
-    digitalWrite(DB1,  (Data >> 1)  & 0x01);
-    digitalWrite(DB2,  (Data >> 2)  & 0x01);
-    digitalWrite(DB3,  (Data >> 3)  & 0x01);
-    digitalWrite(DB4,  (Data >> 4)  & 0x01);
-    digitalWrite(DB5,  (Data >> 5)  & 0x01);
-    digitalWrite(DB6,  (Data >> 6)  & 0x01);
-    digitalWrite(DB7,  (Data >> 7)  & 0x01);
-    digitalWrite(DB8,  (Data >> 8)  & 0x01);
-    digitalWrite(DB9,  (Data >> 9)  & 0x01);
-    digitalWrite(DB10, (Data >> 10) & 0x01);
-    digitalWrite(DB11, (Data >> 11) & 0x01);
-  
-    // Schreiben vorbereiten
-    digitalWrite(CS, LOW);         // Chip aktivieren
-    delayMicroseconds(1);          // Setup-Zeit (tWS ≥ 0 ns)
-    digitalWrite(CS, HIGH);       // Lesen deaktivieren (Schreiben aktivieren)
-   
-  
-    // Daten übernehmen (Load)
-  
-    //delayMicroseconds(1);        // tLDW ≥ 170 ns laut Datenblatt
-    //digitalWrite(Load_Data, LOW); // LDAC deaktivieren
-  
-    // Schreiben beenden
-   // digitalWrite(R_W, HIGH);       // Schreiben beenden (nicht zwingend nötig, aber klar)
-    //digitalWrite(CS, HIGH);        // Chip deaktivieren
-  
-  }
-
-// FreeRTOS Task Handle
+// FreeRTOS Task Handle (einmalig beim Booten angelegt)
 TaskHandle_t abspielTaskHandle = nullptr;
-extern int ausgabeFrequenzHz;
 
-void abspielTask(void* parameter) {
-    Serial.println("Starte Abspielen der Daten (FreeRTOS Task)...");
+// Steuerung des Abspiel-Tasks: Armieren bereitet alles bis zum ersten Frame vor,
+// Start gibt nur noch die Ausgabe frei
+static SemaphoreHandle_t armierSignal = nullptr;
+static SemaphoreHandle_t startSignal = nullptr;
+static volatile WiedergabeZustand zustand = WiedergabeZustand::LEERLAUF;
+// Armieren aus dem Leerlauf (auch durch den Trigger-Interrupt) und die Sperre
+// der Kanaltabelle schließen einander aus
+static portMUX_TYPE zustandMux = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool tabelleGesperrt = false;
+static volatile bool stoppAngefordert = false;
+static volatile int64_t startAnforderungUs = 0;
+static volatile bool kaltstart = false;
+static volatile bool startDurchTrigger = false;
+static volatile bool weiterAngefordert = false;
+static StartLatenz startLatenz;
 
-    // Hier definieren wir die Min- und Max-Werte für das EEG-Signal (in mV)
-    float minEEG = -150.0f; // mV (Minimum des EEG-Signals)
-    float maxEEG = 150.0f;  // mV (Maximum des EEG-Signals)
+// Ausgabetakt: Einmal-Timer auf die nächste Frist, der Callback weckt den Task
+static esp_timer_handle_t taktTimer = nullptr;
+static SemaphoreHandle_t taktSignal = nullptr;
 
-    // Maximale Länge aller Kanäle bestimmen
-    size_t maxLength = 0;
-    if (kanalDaten.empty()) {
-        Serial.println("⚠️ Keine Kanal-Daten geladen. Task wird abgebrochen.");
-        abspielTaskHandle = nullptr;
-        vTaskDelete(nullptr);
-        return;
+// Frequenzwechsel vom Webserver; der Task übernimmt ihn am nächsten Quellframe
+static portMUX_TYPE taktMux = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t taktAenderung = 0;   // zählt jede neue Vorgabe
+static float taktRampeS = 0.0f;
+static volatile float istFrequenzHz = 0.0f;
+
+FilterEinstellung filterEinstellung;
+
+// Fertig kalibrierte DAC-Codes des aktuellen Blocks pro Kanal (bei Überabtastung faktor-fach)
+static uint16_t codePuffer[ANZAHL_KANAELE][KONVERTIERUNG_BLOCK * FILTER_MAX_FAKTOR];
+static uint16_t rohPuffer[KONVERTIERUNG_BLOCK];
+static Q15 generatorPuffer[KONVERTIERUNG_BLOCK];
+
+// Marker des aktuellen Blocks pro Quellsample (erster Kanal gewinnt)
+static const Marker* blockMarker[KONVERTIERUNG_BLOCK];
+static uint8_t blockMarkerKanal[KONVERTIERUNG_BLOCK];
+// DAC-Ausgang pro Datenkanal (Kanalzuordnung, beim Start der Wiedergabe kopiert)
+static uint8_t ausgang[ANZAHL_KANAELE];
+static InterpolationsFilter filter;
+static FilterZustand filterZustand[ANZAHL_KANAELE];
+static bool filterAktiv = false;
+
+std::array<KanalArtefakte, ANZAHL_KANAELE> artefaktEinstellungen;
+static KanalArtefaktZustand artefaktZustand[ANZAHL_KANAELE];
+
+// Quelltakt beim Start der Wiedergabe: Generator und Artefakte bleiben an die
+// Samples gebunden und laufen bei einer Frequenzänderung mit
+static float quellFrequenzHz = 100.0f;
+
+static void taktCallback(void*) {
+    xSemaphoreGive(taktSignal);
+}
+
+// Schläft bis zur Frist (Takt.hpp)
+static void warteAufFrist(Takt& takt) {
+    const int64_t rest = restBisFrist(takt, esp_timer_get_time());
+    if (rest <= 0) return;
+    esp_timer_start_once(taktTimer, rest);
+    xSemaphoreTake(taktSignal, portMAX_DELAY);
+}
+
+// Frequenzvorgabe und laufende Rampe im Abspiel-Task
+struct TaktRampe {
+    uint32_t aenderung = 0;
+    float vonHz = 0.0f;
+    float nachHz = 0.0f;
+    int64_t beginnUs = 0;
+    int64_t dauerUs = 0;     // 0 = keine Rampe aktiv
+};
+
+// Am Quellframe: neue Vorgabe übernehmen bzw. die Rampe fortschreiben; true bei neuem Takt
+static bool aktualisiereTakt(TaktRampe& rampe, float& hz) {
+    if (taktAenderung != rampe.aenderung) {
+        portENTER_CRITICAL(&taktMux);
+        rampe.aenderung = taktAenderung;
+        rampe.nachHz = ausgabeFrequenzHz;
+        const float rampeS = taktRampeS;
+        portEXIT_CRITICAL(&taktMux);
+        rampe.vonHz = hz;
+        rampe.beginnUs = esp_timer_get_time();
+        rampe.dauerUs = (int64_t)(rampeS * 1e6f);
+        if (rampe.dauerUs <= 0) {
+            hz = rampe.nachHz;
+            return true;
+        }
     }
+    if (rampe.dauerUs <= 0) return false;
+    const int64_t vergangen = esp_timer_get_time() - rampe.beginnUs;
+    if (vergangen >= rampe.dauerUs) {
+        hz = rampe.nachHz;
+        rampe.dauerUs = 0;
+    } else {
+        hz = rampe.vonHz + (rampe.nachHz - rampe.vonHz) * ((float)vergangen / (float)rampe.dauerUs);
+    }
+    return true;
+}
+
+// Phasenschritt des Sinusgenerators pro Quellsample (einmal pro Block berechnet)
+static inline uint32_t phasenSchritt(float frequenzHz) {
+    float umdrehungen = frequenzHz / quellFrequenzHz;
+    if (!(umdrehungen > 0.0f)) return 0;
+    if (umdrehungen >= 0.5f) umdrehungen = 0.5f;   // höchstens Nyquist
+    return (uint32_t)(umdrehungen * 4294967296.0f);
+}
 
-    // Bestimmung der maximalen Datenlänge über alle Kanäle hinweg
-    for (const auto& [_, data] : kanalDaten) {
-        if (data.size() > maxLength) {
-            maxLength = data.size();
+static KanalZeitachse zeitachse[ANZAHL_KANAELE];
+
+// Zeitachse aller Kanäle einer Tabelle (pro Segment, außerhalb der Ausgabe)
+static void richteZeitachseAus(const KanalTabelle& tabelle) {
+    for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) {
+        zeitachse[index] = berechneZeitachse(tabelle[index].abtastrateHz, tabelle[index].versatzS, quellFrequenzHz);
+    }
+}
+
+// Unkalibrierter Code des ersten Ausgabesamples eines Kanals
+static inline uint16_t rohCode(const Kanal& kanal, uint8_t index) {
+    const bool daten = zeitachse[index].beginn == 0 && !kanal.samples.empty();
+    return codeAusQ15(daten ? kanal.samples[0] : kanal.skalierung.ruhe);
+}
+
+// Rechnet den nächsten Block ab Sample 'beginn' um; über das Kanalende hinaus 0 mV
+static void fuelleCodePuffer(const Kanal& kanal, uint8_t index, size_t beginn, size_t anzahl) {
+    const uint16_t* lut = kalibrierLut[ausgang[index]];
+    // Ohne Artefakte und Filter: Skalierung und Kalibrierung in einem Durchlauf,
+    // sonst unkalibriert mischen/filtern und die Kalibrierung zum Schluss anwenden
+    const bool roh = filterAktiv || artefaktZustand[index].aktiv;
+    const uint16_t* konvLut = roh ? nullptr : lut;
+    uint16_t* ziel = filterAktiv ? rohPuffer : codePuffer[index];
+
+    uint16_t ruhe = codeAusQ15(kanal.skalierung.ruhe);
+    if (!roh) ruhe = lut[ruhe];
+
+    size_t vorhanden = 0;
+    if (kanal.sinus.aktiv()) {
+        // Phase (2^32 = eine Umdrehung) aus der Sampleposition: stetig über
+        // Blockgrenzen, ohne Zustand; der Überlauf ist das Modulo
+        const uint32_t schritt = phasenSchritt(kanal.sinus.frequenzHz);
+        uint32_t phase = (uint32_t)beginn * schritt;
+        for (size_t j = 0; j < anzahl; ++j) {
+            generatorPuffer[j] = kanal.skalierung.ruhe + sinusQ15(phase) * kanal.sinus.amplitude;
+            phase += schritt;
         }
+        konvertiereBlock(generatorPuffer, anzahl, konvLut, ziel);
+        vorhanden = anzahl;
+    } else {
+        // Vor dem Startversatz 0 mV
+        const KanalZeitachse& za = zeitachse[index];
+        if (beginn < za.beginn) {
+            vorhanden = za.beginn - beginn;
+            if (vorhanden > anzahl) vorhanden = anzahl;
+            for (size_t j = 0; j < vorhanden; ++j) ziel[j] = ruhe;
+        }
+        const size_t vorlauf = vorhanden;
+        const size_t start = beginn + vorlauf - za.beginn;   // ab Kanalbeginn
+        const size_t groesse = kanal.samples.size();
+        if (!za.direkt) {
+            const size_t n = tasteBlockAb(kanal.samples.data(), groesse, kanal.schleife, za, start,
+                                          anzahl - vorlauf, generatorPuffer);
+            konvertiereBlock(generatorPuffer, n, konvLut, ziel + vorlauf);
+            vorhanden += n;
+        }
+        // Bei Schleife in mehreren Stücken über das Kanalende hinweg
+        while (za.direkt && vorhanden < anzahl && groesse > 0) {
+            size_t pos = start + (vorhanden - vorlauf);
+            if (kanal.schleife) pos %= groesse;
+            else if (pos >= groesse) break;
+            size_t stueck = groesse - pos;
+            if (stueck > anzahl - vorhanden) stueck = anzahl - vorhanden;
+            konvertiereBlock(&kanal.samples[pos], stueck, konvLut, ziel + vorhanden);
+            vorhanden += stueck;
+        }
+    }
+    for (size_t j = vorhanden; j < anzahl; ++j) ziel[j] = ruhe;
+
+    mischeArtefakte(artefaktZustand[index], ziel, anzahl);
+
+    if (filterAktiv) {
+        uint16_t* aus = codePuffer[index];
+        interpoliereBlock(filter, filterZustand[index], rohPuffer, anzahl, aus);
+        mischeBrummen(artefaktZustand[index], aus, anzahl * filter.faktor);
+        for (size_t j = 0; j < anzahl * filter.faktor; ++j) aus[j] = lut[aus[j]];
+    } else if (roh) {
+        mischeBrummen(artefaktZustand[index], ziel, anzahl);
+        for (size_t j = 0; j < anzahl; ++j) ziel[j] = lut[ziel[j]];
+    }
+}
+
+static inline void setzeBlockMarker(size_t slot, const Marker* marker, uint8_t index) {
+    if (blockMarker[slot] == nullptr) {
+        blockMarker[slot] = marker;
+        blockMarkerKanal[slot] = index;
     }
+}
+
+// Erster Marker mit Samplenummer in [von, bis), sonst nullptr
+static const Marker* markerZwischen(const Kanal& kanal, size_t von, size_t bis) {
+    auto it = std::lower_bound(kanal.marker.begin(), kanal.marker.end(), von,
+                               [](const Marker& m, size_t s) { return m.sample < s; });
+    return (it != kanal.marker.end() && it->sample < bis) ? &*it : nullptr;
+}
+
+// Trägt die Marker eines Kanals für die Ausgabesamples ab 'beginn' in blockMarker ein
+static void sammleMarker(const Kanal& kanal, uint8_t index, size_t beginn, size_t anzahl) {
+    const KanalZeitachse& za = zeitachse[index];
+    const size_t groesse = kanal.samples.size();
+    const size_t vorlauf = (beginn < za.beginn) ? std::min(za.beginn - beginn, anzahl) : 0;
+    const size_t start = beginn + vorlauf - za.beginn;
 
-    Serial.printf("Maximale Länge aller Kanäle: %zu\n", maxLength);
-    if (maxLength == 0) {
-        Serial.println("⚠️ Kanäle vorhanden, aber alle leer. Task wird beendet.");
-        abspielTaskHandle = nullptr;
-        vTaskDelete(nullptr);
+    if (!za.direkt) {
+        // Ein Marker erscheint im ersten Ausgabesample, dessen Position ihn erreicht
+        // oder (bei niedrigerem Ausgabetakt) überspringt; 'naechste' ist die erste
+        // noch nicht erreichte Kanalposition
+        KanalPhase phase(za, start);
+        uint32_t naechste = start == 0 ? 0 : KanalPhase(za, start - 1).pos + 1;
+        for (size_t j = vorlauf; j < anzahl && groesse > 0; ++j) {
+            const uint32_t bis = phase.pos + 1;
+            if (!kanal.schleife && naechste >= groesse) break;
+            const Marker* m = nullptr;
+            if (bis > naechste) {
+                if (!kanal.schleife) {
+                    m = markerZwischen(kanal, naechste, bis);
+                } else if (bis - naechste >= groesse) {
+                    m = kanal.marker.empty() ? nullptr : &kanal.marker.front();
+                } else {
+                    const size_t von = naechste % groesse;
+                    const size_t ende = von + (bis - naechste);
+                    m = markerZwischen(kanal, von, ende);
+                    if (m == nullptr && ende > groesse) m = markerZwischen(kanal, 0, ende - groesse);
+                }
+            }
+            if (m != nullptr) setzeBlockMarker(j, m, index);
+            naechste = bis;
+            phase.weiter(za);
+        }
         return;
     }
 
-    // Abspielen der Daten in einer Schleife
-    for (size_t i = 0; i < maxLength; ++i) {
-        for (const auto& [channel, data] : kanalDaten) {
-            // Werte aus den geladenen Daten holen (mV)
-            float value = (i < data.size()) ? data[i] : 0.0f;
+    size_t fertig = vorlauf;
+    while (fertig < anzahl && groesse > 0) {
+        size_t pos = start + (fertig - vorlauf);
+        if (kanal.schleife) pos %= groesse;
+        else if (pos >= groesse) break;
+        size_t stueck = groesse - pos;
+        if (stueck > anzahl - fertig) stueck = anzahl - fertig;
+
+        auto it = std::lower_bound(kanal.marker.begin(), kanal.marker.end(), pos,
+                                   [](const Marker& m, size_t s) { return m.sample < s; });
+        for (; it != kanal.marker.end() && it->sample < pos + stueck; ++it) {
+            setzeBlockMarker(fertig + (it->sample - pos), &*it, index);
+        }
+        fertig += stueck;
+    }
+}
+
+// Rechnet den Block ab Sample 'i' für alle ausgegebenen Kanäle um und sammelt die Marker
+static void fuelleBlock(const KanalTabelle& tabelle, const bool* ausgabeKanal, size_t i, size_t anzahl) {
+    for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) {
+        if (ausgabeKanal[index]) fuelleCodePuffer(tabelle[index], index, i, anzahl);
+    }
+    memset(blockMarker, 0, sizeof(blockMarker));
+    for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) {
+        if (ausgabeKanal[index] && !tabelle[index].marker.empty()) sammleMarker(tabelle[index], index, i, anzahl);
+    }
+}
 
-            // Skalierung der Werte von -100 mV bis +100 mV auf den DAC-Bereich von 0 bis 4095
-            // Der Mittelwert von 0 mV wird auf den Wert 2047 (Mitte des DAC-Bereichs) gesetzt
-            float range = maxEEG - minEEG;
-            if (range == 0) range = 1;  // Sicherheitsabfrage gegen Division durch 0
+// Liefert das nächste Segment: im Szenario vom Sequenzer, sonst einmalig die Kanaltabelle
+static bool holeSegment(bool erstes, const KanalTabelle*& tabelle, size_t& laenge) {
+    if (szenarioAktiv()) {
+        if (!szenarioNaechstesSegment(tabelle, laenge)) return false;
+        richteZeitachseAus(*tabelle);
+        return true;
+    }
+    if (!erstes) return false;
 
-            // Normalisierung der Werte zwischen 0 und 1
-            double normalized = (value - minEEG) / range;
-            normalized = constrain(normalized, 0.0f, 1.0f);
+    // Bestimmung der maximalen Länge auf der Zeitachse über alle Kanäle hinweg;
+    // Marker in Sekunden mit der Kanalrate bzw. dem jetzt gültigen Quelltakt
+    tabelle = &kanalTabelle;
+    richteZeitachseAus(kanalTabelle);
+    laenge = 0;
+    for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) {
+        Kanal& kanal = kanalTabelle[index];
+        setzeMarkerRate(kanal.marker, kanal.abtastrateHz > 0.0f ? kanal.abtastrateHz : quellFrequenzHz);
+        laenge = std::max(laenge, zeitachsenLaenge(kanal.samples.size(), zeitachse[index]));
+    }
+    return laenge > 0;
+}
 
-            // Umrechnung auf den DAC-Bereich 0-4095
-            uint16_t dacValue;
-            dacValue = static_cast<uint16_t>(normalized * 4095.0f);
+// Marker, der auf seinen Ausgabeframe wartet (Gruppenlaufzeit des Filters);
+// Text kopiert, da die Segmenttabelle bis dahin schon neu geladen sein kann
+struct WartenderMarker {
+    size_t frame = 0;
+    uint32_t sample = 0;
+    uint8_t kanal = 0;
+    char text[MARKER_TEXT_LAENGE] = {};
+};
+#define MARKER_WARTESCHLANGE  16
 
+// Zustand einer laufenden Wiedergabe; die Schritte ruft spieleBloecke() auf
+// (Blockablauf.hpp)
+struct Wiedergabe {
+    const KanalTabelle* tabelle = nullptr;
+    const bool* ausgabeKanal = nullptr;
+    bool szenarioModus = false;
+    uint8_t faktor = 1;
+    SyncModus sync = SyncModus::AUS;
+    TaktRampe rampe;
+    float taktHz = 0.0f;
+    Takt takt;
+    uint8_t syncAusfaelle = 0;
+    bool syncAuslassen = false;
+    bool markerPegel = false;
+    size_t markerEndeFrame = 0;
+    // Marker erscheinen mit dem gefilterten Sample, d. h. um die
+    // Gruppenlaufzeit des Filters (in Ausgabeframes) verzögert
+    uint16_t markerVerzoegerung = 0;
+    WartenderMarker warteschlange[MARKER_WARTESCHLANGE];
+    uint8_t warteLesen = 0;
+    uint8_t warteAnzahl = 0;
+    bool latenzOffen = false;
+    size_t sampleBasis = 0;
+    size_t frameAnzahl = 0;
+    uint32_t segmentAnzahl = 0;
+    uint32_t maxFrameUs = 0;
+    uint32_t ueberlaeufe = 0;
+    uint32_t konvertierungUs = 0;
 
+    bool abbrechen() const {
+        return stoppAngefordert || (szenarioModus && szenarioAbgebrochen());
+    }
+
+    // Trigger "weiter": Segment nach dem gerade ausgegebenen Quellsample beenden
+    bool segmentEnde() {
+        if (!weiterAngefordert) return false;
+        weiterAngefordert = false;
+        return true;
+    }
+
+    bool naechstesSegment(size_t& laenge) {
+        sampleBasis += laenge;
+        if (abbrechen() || !holeSegment(false, tabelle, laenge)) return false;
+        segmentAnzahl++;
+        return true;
+    }
+
+    // Blockweise Umrechnung Q15 -> kalibrierter DAC-Code für alle Kanäle
+    void fuelle(size_t i, size_t anzahl) {
+        const uint32_t start = micros();
+        fuelleBlock(*tabelle, ausgabeKanal, i, anzahl);
+        konvertierungUs += micros() - start;
+    }
+
+    // Voll nur bei mehr als MARKER_WARTESCHLANGE Markern innerhalb der
+    // Gruppenlaufzeit; der neue Marker entfällt dann
+    void merkeMarker(const Marker& marker, uint8_t kanal, uint32_t sample) {
+        if (warteAnzahl >= MARKER_WARTESCHLANGE) return;
+        WartenderMarker& eintrag = warteschlange[(warteLesen + warteAnzahl) % MARKER_WARTESCHLANGE];
+        eintrag.frame = frameAnzahl + markerVerzoegerung;
+        eintrag.sample = sample;
+        eintrag.kanal = kanal;
+        memcpy(eintrag.text, marker.text, MARKER_TEXT_LAENGE);
+        warteAnzahl++;
+    }
+
+    bool frame(size_t i, size_t blockPos) {
+        const bool quellFrame = (blockPos % faktor) == 0;
+        // Frequenzwechsel nur an Quellframes: die Periode gilt ab diesem Frame
+        if (quellFrame && aktualisiereTakt(rampe, taktHz)) {
+            setzePeriode(takt, taktHz * faktor);
+            istFrequenzHz = taktHz;
+        }
+
+        if (quellFrame && sync == SyncModus::MASTER) {
+            syncPulsSenden();
+        } else if (quellFrame && sync == SyncModus::SLAVE) {
+            // Erster Puls = koordinierter Start durch den Master
+            const bool start = (frameAnzahl == 0);
+            const uint32_t quellPeriodeUs = takt.periodeUs * faktor;
+            TickType_t timeout = start ? pdMS_TO_TICKS(SYNC_START_TIMEOUT_MS)
+                                       : pdMS_TO_TICKS(2 * quellPeriodeUs / 1000) + 1;
+            switch (syncWarten((uint32_t)(sampleBasis + i + blockPos / faktor), quellPeriodeUs, timeout)) {
+                case SyncSchritt::AUSGEBEN:
+                    syncAusfaelle = 0;
+                    syncAuslassen = false;
+                    // Unterframes ab dem Puls takten
+                    takt.fristUs = esp_timer_get_time();
+                    takt.fristBruch = 0;
+                    break;
+                case SyncSchritt::AUSLASSEN:
+                    // Rückstand aufholen: Quellsample samt Unterframes überspringen
+                    syncAuslassen = true;
+                    return true;
+                case SyncSchritt::ZEITUEBERSCHREITUNG:
+                    if (start || ++syncAusfaelle >= SYNC_MAX_AUSFAELLE) {
+                        Serial.println("⚠️ Kein Sync-Puls vom Master, Wiedergabe beendet.");
+                        return false;
+                    }
+                    syncAuslassen = false;
+                    break;
+            }
+        }
+        if (syncAuslassen) return true;
+        const uint32_t frameStart = micros();
+
+        // Alle Eingangsregister laden, dann alle Ausgänge gleichzeitig übernehmen
+        for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) {
+            if (!ausgabeKanal[index]) continue;
+            uint16_t dacValue = codePuffer[index][blockPos];
+
+#ifdef DEBUG_AUSGABE
             // Ausgabe des Wertes in der Konsole zur Überprüfung
-            Serial.print("Kanal ");
-            Serial.print(channel);
-            Serial.print(" → ");
-            Serial.print(value, 2);  // Wert in mV
-            Serial.print(" mV → DAC-Wert: ");
-            Serial.println(dacValue);
+            Serial.printf("Kanal %u → DAC-Wert: %u\n", index, dacValue);
+#endif
 
             // Ausgabe des DAC-Werts an den entsprechenden Kanal
-            ausgabe(channel[3], dacValue);
+            ausgabe(ausgang[index], dacValue);
+        }
+        // Marker für ein Quellsample im selben Frame wie die DAC-Übernahme
+        // (nach der Gruppenlaufzeit), Ausgang ein Quellsample lang gesetzt
+        if (quellFrame && blockMarker[blockPos / faktor] != nullptr) {
+            merkeMarker(*blockMarker[blockPos / faktor], blockMarkerKanal[blockPos / faktor],
+                        sampleBasis + i + blockPos / faktor);
+        }
+        const WartenderMarker* marker =
+            (warteAnzahl > 0 && warteschlange[warteLesen].frame == frameAnzahl) ? &warteschlange[warteLesen] : nullptr;
+        if (marker != nullptr || (markerPegel && frameAnzahl >= markerEndeFrame)) {
+            uint32_t takte = dacFrameMitMarker(marker != nullptr);
+            markerPegel = (marker != nullptr);
+            if (marker != nullptr) {
+                markerEndeFrame = frameAnzahl + faktor;
+                MarkerEreignis ereignis;
+                ereignis.sample = marker->sample;
+                ereignis.zeitUs = esp_timer_get_time();
+                ereignis.latenzNs = takte * 1000UL / ESP.getCpuFreqMHz();
+                ereignis.kanal = marker->kanal;
+                memcpy(ereignis.text, marker->text, MARKER_TEXT_LAENGE);
+                protokolliereMarker(ereignis);
+                warteLesen = (warteLesen + 1) % MARKER_WARTESCHLANGE;
+                warteAnzahl--;
+            }
+        } else {
+            dacFrameUebernehmen();
+        }
+        frameAnzahl++;
 
-            // RTOS-Kooperation
-            yield();
+        // Startlatenz: Startbefehl bis zur ersten DAC-Übernahme
+        if (latenzOffen) {
+            uint32_t latenz = (uint32_t)(esp_timer_get_time() - startAnforderungUs);
+            latenzOffen = false;
+            startLatenz.letzteUs = latenz;
+            startLatenz.kaltstart = kaltstart;
+            if (!kaltstart && latenz > startLatenz.maxArmiertUs) startLatenz.maxArmiertUs = latenz;
+            startLatenz.anzahl++;
+            if (startDurchTrigger) meldeTriggerLatenz(latenz);
+            meldeErsteAusgabe();
         }
-        // Verzögerung, um die gewünschte Abspiel-Frequenz zu erreichen
-        vTaskDelay(pdMS_TO_TICKS(1000 / ausgabeFrequenzHz));
+
+        uint32_t frameUs = micros() - frameStart;
+        if (frameUs > maxFrameUs) maxFrameUs = frameUs;
+        if (frameUs >= takt.periodeUs) ueberlaeufe++;
+        return true;
+    }
+
+    void warte(size_t blockPos) {
+        // Slave: der nächste Quellframe wartet auf den Puls statt auf den Timer,
+        // ausgelassene Frames gar nicht
+        if (sync == SyncModus::SLAVE && (syncAuslassen || (blockPos + 1) % faktor == 0)) return;
+        // Feste Periode unabhängig von der Schreibdauer, der Task schläft dazwischen
+        naechsteFrist(takt);
+        warteAufFrist(takt);
+    }
+};
+
+// Eine Wiedergabe: vorbereiten, auf den Start warten, abspielen
+static void spieleAb() {
+    Serial.println("Bereite Abspielen der Daten vor...");
+
+    // Änderungen bis zur Freigabe übernimmt der erste Frame
+    const uint32_t startAenderung = taktAenderung;
+    const float startHz = ausgabeFrequenzHz;
+
+    // Im Szenario gilt der Takt beim Szenariostart, auf den das Vorladen
+    // Segmentdauer und Marker bezieht
+    const bool szenarioModus = szenarioAktiv();
+    quellFrequenzHz = szenarioModus ? szenarioAbtastrate() : startHz;
+    const KanalTabelle* tabelle = nullptr;
+    size_t laenge = 0;
+    if (!holeSegment(true, tabelle, laenge)) {
+        Serial.println("⚠️ Keine Kanal-Daten geladen. Wiedergabe wird abgebrochen.");
+        if (szenarioModus) beendeSzenario();
+        return;
+    }
+
+    Serial.printf("Länge des ersten Segments: %zu\n", laenge);
+
+    // Ausgegeben werden alle Kanäle, die irgendwann Daten führen (sonst 0 mV)
+    bool ausgabeKanal[ANZAHL_KANAELE];
+    size_t kanalAnzahl = 0;
+    for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) {
+        ausgabeKanal[index] = szenarioModus ? szenarioNutztKanal(index) : (*tabelle)[index].aktiv();
+        if (ausgabeKanal[index]) kanalAnzahl++;
+    }
+
+    memcpy(ausgang, konfiguration().kanalZuordnung, sizeof(ausgang));
+
+    // Filterkoeffizienten beim Start aus der aktuellen Einstellung berechnen
+    filterAktiv = filterEinstellung.aktiv();
+    uint8_t faktor = 1;
+    if (filterAktiv) {
+        entwerfeFilter(filterEinstellung, filter);
+        faktor = filter.faktor;
+        for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) {
+            if (ausgabeKanal[index]) setzeFilterZustand(filter, filterZustand[index], rohCode((*tabelle)[index], index));
+        }
+        Serial.printf("Rekonstruktionsfilter: %u-fache Überabtastung, %u Taps/Phase\n", faktor, filter.taps);
+    }
+
+    // Artefakte auf Quell- bzw. Ausgabetakt und Kanalskalierung (des ersten Segments) umrechnen
+    for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) {
+        const Kanal& kanal = (*tabelle)[index];
+        artefaktZustand[index] = KanalArtefaktZustand();
+        if (!ausgabeKanal[index] || !artefaktEinstellungen[index].aktiv()) continue;
+        const ArtefaktEinstellung& brummen = artefaktEinstellungen[index].typ[NETZBRUMMEN];
+        if (brummen.aktiv && !brummenDarstellbar(brummen.frequenzHz, quellFrequenzHz * faktor)) {
+            Serial.printf("⚠️ Netzbrummen %.1f Hz bei %.1f Hz Ausgabetakt nicht darstellbar, %s ohne Brummen\n",
+                          brummen.frequenzHz, quellFrequenzHz * faktor, kanalName(index).c_str());
+        }
+        bereiteArtefakteVor(artefaktEinstellungen[index], kanal.skalierung.codesProMv,
+                            quellFrequenzHz, quellFrequenzHz * faktor, esp_random(), artefaktZustand[index]);
     }
 
+    loescheMarkerProtokoll();
+
+    // Statisch wie die Puffer oben: die Marker-Warteschlange allein belegt
+    // mehrere 100 Bytes, die sonst der Stack des Abspiel-Tasks tragen müsste
+    static Wiedergabe w;
+    w = Wiedergabe();
+    w.tabelle = tabelle;
+    w.ausgabeKanal = ausgabeKanal;
+    w.szenarioModus = szenarioModus;
+    w.faktor = faktor;
+    w.markerVerzoegerung = filterAktiv ? gruppenlaufzeit(filter) : 0;
+    // Gleichlauf: Master sendet, Slave wartet vor jedem Quellsample auf den Puls
+    w.sync = syncModus();
+    syncStart(xTaskGetCurrentTaskHandle());
+
+    // Ersten Block vorab füllen, dann scharf warten
+    w.fuelle(0, laenge < KONVERTIERUNG_BLOCK ? laenge : KONVERTIERUNG_BLOCK);
+
+    zustand = WiedergabeZustand::BEREIT;
+    xSemaphoreTake(startSignal, portMAX_DELAY);
+    zustand = WiedergabeZustand::LAEUFT;
+    w.latenzOffen = (w.sync != SyncModus::SLAVE);
+    weiterAngefordert = false;
+
+    // Takt ab der Freigabe
+    w.rampe.aenderung = startAenderung;
+    w.taktHz = startHz;
+    istFrequenzHz = w.taktHz;
+    setzePeriode(w.takt, w.taktHz * faktor);
+    w.takt.fristUs = esp_timer_get_time();
+    xSemaphoreTake(taktSignal, 0);
+
+    // Ab hier nur noch statische Puffer; der Prüfbuild bricht bei jeder Anforderung ab
+    beginneHeapfreieZone();
+    // Segmente lückenlos nacheinander abspielen; der Wechsel fällt auf eine Blockgrenze
+    w.segmentAnzahl = 1;
+    spieleBloecke(w, laenge, KONVERTIERUNG_BLOCK, faktor);
+    beendeHeapfreieZone();
+    if (w.markerPegel) digitalWrite(MARKER_PIN, LOW);
+    syncStopp();
+    istFrequenzHz = 0.0f;
+
+    Serial.printf("Frame-Dauer max. %u µs für %u Kanäle (max. %u Hz), %u Überläufe\n",
+                  w.maxFrameUs, (unsigned)kanalAnzahl,
+                  w.maxFrameUs ? (unsigned)(1000000UL / w.maxFrameUs) : 0, w.ueberlaeufe);
+    Serial.printf("Konvertierung%s: %.1f ns/Ausgabewert\n", filterAktiv ? " + Filter" : "",
+                  w.frameAnzahl ? 1000.0f * w.konvertierungUs / ((float)w.frameAnzahl * kanalAnzahl) : 0.0f);
+    MarkerStatistik markerStat;
+    leseMarkerProtokoll(nullptr, 0, markerStat);
+    if (markerStat.anzahl > 0) {
+        Serial.printf("Marker: %u ausgegeben, Latenz LDAC→Marker max. %u ns\n",
+                      markerStat.anzahl, markerStat.maxLatenzNs);
+    }
+    if (w.sync != SyncModus::AUS) {
+        SyncStatistik st = holeSyncStatistik();
+        Serial.printf("Sync (%s): %u Pulse, Periode %u–%u µs, %u Ausfälle, Latenz max. %u µs\n",
+                      syncModusAlsText(w.sync), st.pulse, st.minPeriodeUs, st.maxPeriodeUs,
+                      st.ausfaelle, st.maxLatenzUs);
+    }
+    if (szenarioModus) {
+        Serial.printf("Szenario: %u Segmente, %u Unterläufe beim Vorladen\n",
+                      w.segmentAnzahl, holeSzenarioStatus().unterlaeufe);
+        beendeSzenario();
+    }
+    Serial.printf("Stack des Abspiel-Tasks: %u von %u Bytes nie benutzt\n",
+                  (unsigned)uxTaskGetStackHighWaterMark(nullptr), (unsigned)ABSPIEL_TASK_STACK);
+    if (startLatenz.anzahl > 0) {
+        Serial.printf("Startlatenz: %u µs (%s)\n", startLatenz.letzteUs,
+                      startLatenz.kaltstart ? "ohne Armierung" : "armiert");
+    }
     Serial.println("Abspielen der Daten abgeschlossen.");
-    abspielTaskHandle = nullptr;
-    vTaskDelete(nullptr); // Task selbst löschen
 }
 
+// Dauerhafter Task: wartet auf Armierung, spielt ab, kehrt in den Leerlauf zurück
+static void abspielTask(void* parameter) {
+    for (;;) {
+        xSemaphoreTake(armierSignal, portMAX_DELAY);
+        spieleAb();
+        xSemaphoreTake(startSignal, 0);   // nicht verbrauchten Start verwerfen
+        stoppAngefordert = false;
+        zustand = WiedergabeZustand::LEERLAUF;
+    }
+}
 
 
-// Startfunktion für den Task
-void startAbspielTask() {
-    if (abspielTaskHandle == nullptr) {
-        xTaskCreatePinnedToCore(
-            abspielTask,         // Task-Funktion
-            "AbspielTask",       // Name
-            4096,                // Stack-Größe
-            nullptr,             // Parameter
-            1,                   // Priorität
-            &abspielTaskHandle,  // Handle
-            1                    // Core (1 = App Core auf ESP32)
-        );
-    } else {
+
+size_t anzahlAktiverKanaele() {
+    size_t anzahl = 0;
+    for (const Kanal& kanal : kanalTabelle) {
+        if (kanal.aktiv()) anzahl++;
+    }
+    return anzahl;
+}
+
+bool wiedergabeAktiv() {
+    return zustand != WiedergabeZustand::LEERLAUF;
+}
+
+WiedergabeZustand wiedergabeZustand() {
+    return zustand;
+}
+
+StartLatenz holeStartLatenz() {
+    return startLatenz;
+}
+
+const char* wiedergabeZustandAlsText(WiedergabeZustand z) {
+    switch (z) {
+        case WiedergabeZustand::VORBEREITUNG: return "arming";
+        case WiedergabeZustand::BEREIT:       return "armed";
+        case WiedergabeZustand::LAEUFT:       return "playing";
+        default:                              return "idle";
+    }
+}
+
+// Legt den Abspiel-Task einmalig an (Stack und Puffer stehen danach fest)
+void initAbspielTask() {
+    if (abspielTaskHandle != nullptr) return;
+    armierSignal = xSemaphoreCreateBinary();
+    startSignal = xSemaphoreCreateBinary();
+    taktSignal = xSemaphoreCreateBinary();
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = taktCallback;
+    timerArgs.name = "Ausgabetakt";
+    esp_timer_create(&timerArgs, &taktTimer);
+    xTaskCreatePinnedToCore(
+        abspielTask,         // Task-Funktion
+        "AbspielTask",       // Name
+        ABSPIEL_TASK_STACK,  // Stack-Größe
+        nullptr,             // Parameter
+        konfiguration().abspielPrio,  // Priorität (über loop(), für kurze Startlatenz)
+        &abspielTaskHandle,  // Handle
+        ABSPIEL_TASK_CORE    // Core (1 = App Core, frei von WLAN)
+    );
+}
+
+void setzeAusgabeFrequenz(float hz, float rampeS) {
+    if (!(hz > 0.0f)) return;
+    portENTER_CRITICAL(&taktMux);
+    ausgabeFrequenzHz = hz;
+    taktRampeS = (rampeS > 0.0f) ? rampeS : 0.0f;
+    taktAenderung = taktAenderung + 1;
+    portEXIT_CRITICAL(&taktMux);
+}
+
+float aktuelleAusgabeFrequenz() {
+    return wiedergabeAktiv() && istFrequenzHz > 0.0f ? istFrequenzHz : ausgabeFrequenzHz;
+}
+
+void gebeRuhepegelAus() {
+    const uint16_t ruhe = codeAusQ15(KanalSkalierung().ruhe);
+    for (uint8_t index = 0; index < ANZAHL_KANAELE; ++index) ausgabe(index, kalibrierLut[index][ruhe]);
+    dacFrameUebernehmen();
+}
+
+bool sperreKanalTabelle() {
+    portENTER_CRITICAL(&zustandMux);
+    const bool frei = zustand == WiedergabeZustand::LEERLAUF && !tabelleGesperrt;
+    if (frei) tabelleGesperrt = true;
+    portEXIT_CRITICAL(&zustandMux);
+    return frei;
+}
+
+void gibKanalTabelleFrei() {
+    portENTER_CRITICAL(&zustandMux);
+    tabelleGesperrt = false;
+    portEXIT_CRITICAL(&zustandMux);
+}
+
+bool armiereWiedergabe() {
+    portENTER_CRITICAL(&zustandMux);
+    const bool frei = zustand == WiedergabeZustand::LEERLAUF && !tabelleGesperrt;
+    if (frei) {
+        zustand = WiedergabeZustand::VORBEREITUNG;
+        stoppAngefordert = false;
+    }
+    portEXIT_CRITICAL(&zustandMux);
+    if (!frei) return false;
+    xSemaphoreGive(armierSignal);
+    return true;
+}
+
+bool starteWiedergabe() {
+    WiedergabeZustand z = zustand;
+    if (z == WiedergabeZustand::LAEUFT) {
         Serial.println("Abspiel-Task läuft bereits!");
+        return false;
     }
+    kaltstart = (z == WiedergabeZustand::LEERLAUF);
+    if (kaltstart && !armiereWiedergabe()) return false;
+    startDurchTrigger = false;
+    startAnforderungUs = esp_timer_get_time();
+    xSemaphoreGive(startSignal);
+    return true;
+}
+
+void stoppeWiedergabe() {
+    if (zustand == WiedergabeZustand::LEERLAUF) return;
+    stoppAngefordert = true;
+    xSemaphoreGive(startSignal);   // weckt auch eine armierte Wiedergabe
+}
+
+void IRAM_ATTR wiedergabeStartenAusIsr(int64_t zeitUs, BaseType_t* geweckt) {
+    portENTER_CRITICAL_ISR(&zustandMux);
+    const WiedergabeZustand z = zustand;
+    const bool armieren = z == WiedergabeZustand::LEERLAUF;
+    // Kanaltabelle wird gerade ersetzt: Flanke verwerfen
+    const bool verwerfen = z == WiedergabeZustand::LAEUFT || (armieren && tabelleGesperrt);
+    if (!verwerfen && armieren) {
+        zustand = WiedergabeZustand::VORBEREITUNG;
+        stoppAngefordert = false;
+    }
+    portEXIT_CRITICAL_ISR(&zustandMux);
+    if (verwerfen) return;
+    kaltstart = (z != WiedergabeZustand::BEREIT);
+    if (armieren) xSemaphoreGiveFromISR(armierSignal, geweckt);
+    startDurchTrigger = true;
+    startAnforderungUs = zeitUs;
+    xSemaphoreGiveFromISR(startSignal, geweckt);
+}
+
+void IRAM_ATTR wiedergabeStoppenAusIsr(BaseType_t* geweckt) {
+    if (zustand == WiedergabeZustand::LEERLAUF) return;
+    stoppAngefordert = true;
+    xSemaphoreGiveFromISR(startSignal, geweckt);
+}
+
+void IRAM_ATTR wiedergabeUmschaltenAusIsr(int64_t zeitUs, BaseType_t* geweckt) {
+    if (zustand == WiedergabeZustand::LAEUFT) wiedergabeStoppenAusIsr(geweckt);
+    else wiedergabeStartenAusIsr(zeitUs, geweckt);
+}
+
+void IRAM_ATTR wiedergabeWeiterAusIsr() {
+    if (zustand == WiedergabeZustand::LAEUFT) weiterAngefordert = true;
 }
@@ -2,14 +2,72 @@
 #define SPANNUNGSWANDLUNG_H
 #include <Arduino.h>
 #include <vector>
+#include <array>
 #include <map>
 #include <cmath>
+#include "DacRouting.hpp"
+#include "Rekonstruktion.hpp"
+#include "Artefakte.hpp"
+#include "PinMapping.hpp"
 
 
-void ausgabe(char Channel, uint16_t Data);
+enum class WiedergabeZustand : uint8_t { LEERLAUF, VORBEREITUNG, BEREIT, LAEUFT };
 
-void startAbspielTask();
+struct StartLatenz {
+  uint32_t letzteUs = 0;       // Startbefehl bis erste DAC-Übernahme
+  uint32_t maxArmiertUs = 0;   // größter Wert bei Start aus dem armierten Zustand
+  uint32_t anzahl = 0;
+  bool kaltstart = false;      // letzter Start ohne vorherige Armierung
+};
 
-extern int ausgabeFrequenzHz;
+// Dauerhafter Abspiel-Task, einmalig in setup() anlegen
+void initAbspielTask();
+// Alle Kanäle auf kalibrierte 0 mV setzen (beim Start, vor jeder Wiedergabe)
+void gebeRuhepegelAus();
+
+// Bereitet die Wiedergabe bis zum ersten Frame vor (Puffer gefüllt, Filter entworfen)
+bool armiereWiedergabe();
+// Gibt die Ausgabe frei; armiert vorher selbst, falls nötig
+bool starteWiedergabe();
+// Bricht eine armierte oder laufende Wiedergabe am nächsten Block ab
+void stoppeWiedergabe();
+
+// Der Abspiel-Task liest Kanaltabelle, Zuordnung und Kalibrierung ohne Sperre.
+// Wer sie ersetzt, sperrt vorher das Armieren (auch durch den Trigger);
+// gelingt nur im Leerlauf, false = Wiedergabe aktiv oder schon gesperrt
+bool sperreKanalTabelle();
+void gibKanalTabelleFrei();
+
+struct KanalTabellenSperre {
+  const bool gesperrt;
+  explicit KanalTabellenSperre(bool noetig = true) : gesperrt(noetig && sperreKanalTabelle()) {}
+  ~KanalTabellenSperre() { if (gesperrt) gibKanalTabelleFrei(); }
+  KanalTabellenSperre(const KanalTabellenSperre&) = delete;
+  KanalTabellenSperre& operator=(const KanalTabellenSperre&) = delete;
+};
+
+// Aufrufe aus Interrupts (Trigger-Eingang), liegen im IRAM
+void wiedergabeStartenAusIsr(int64_t zeitUs, BaseType_t* geweckt);
+void wiedergabeStoppenAusIsr(BaseType_t* geweckt);
+void wiedergabeUmschaltenAusIsr(int64_t zeitUs, BaseType_t* geweckt);
+// Beendet das laufende Szenario-Segment (ohne Szenario: die Wiedergabe)
+void wiedergabeWeiterAusIsr();
+
+bool wiedergabeAktiv();
+WiedergabeZustand wiedergabeZustand();
+const char* wiedergabeZustandAlsText(WiedergabeZustand zustand);
+StartLatenz holeStartLatenz();
+size_t anzahlAktiverKanaele();
+
+// Ausgabefrequenz (Quelltakt, auch gebrochen, z. B. 512.5 Hz). Eine laufende
+// Wiedergabe übernimmt sie am nächsten Quellframe ohne Neustart; mit rampeS > 0
+// zeitlich linear über rampeS Sekunden (Wiedergabe mit veränderlicher Geschwindigkeit)
+void setzeAusgabeFrequenz(float hz, float rampeS = 0.0f);
+// Momentaner Takt des Abspiel-Tasks (während einer Rampe zwischen alt und neu)
+float aktuelleAusgabeFrequenz();
+
+extern float ausgabeFrequenzHz;   // Sollwert, nur über setzeAusgabeFrequenz() ändern
+extern FilterEinstellung filterEinstellung;
+extern std::array<KanalArtefakte, ANZAHL_KANAELE> artefaktEinstellungen;
 
 #endif // SPANNUNGSWANDLUNG_H
\ No newline at end of file
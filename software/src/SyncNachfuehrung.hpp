@@ -0,0 +1,72 @@
+#ifndef SYNCNACHFUEHRUNG_HPP
+#define SYNCNACHFUEHRUNG_HPP
+
+#include <stdint.h>
+
+// Zuordnung der Master-Pulse zu Quellsamples auf dem Slave, ohne
+// Arduino-Abhängigkeit (Host-Test test/test_synchronisation). Der erste Puls
+// beginnt Sample 0; jeder weitere rückt um die Zahl der aufgelaufenen Pulse
+// vor, mindestens aber um den Abstand zum zuletzt zugeordneten Puls in
+// Perioden (verlorene Pulse). Die Zuordnung hält damit bei Drift und Jitter
+// unter einer Viertelperiode.
+//   - Rückstand (Master voraus): die fehlenden Quellsamples werden ausgelassen,
+//     das Sample des jüngsten Pulses sofort ausgegeben
+//   - Zeitüberschreitung: das Sample läuft im eigenen Takt, der nächste Puls
+//     stellt die Phase wieder her; liegt der Slave danach voraus, wartet er
+//     auf weitere Pulse
+
+enum class SyncSchritt : uint8_t { AUSGEBEN, AUSLASSEN, ZEITUEBERSCHREITUNG };
+
+struct SyncNachfuehrung {
+  bool gestartet = false;
+  int64_t letzterPulsUs = 0;
+  uint32_t masterSample = 0;     // Sample des zuletzt zugeordneten Pulses
+  uint32_t naechsterPuls = 0;    // erstes Quellsample, das einen neuen Puls braucht
+  uint32_t rueckstand = 0;       // Pulse, die während der Ausgabe aufliefen
+  uint32_t ausgelassen = 0;      // übersprungene Quellsamples
+  uint32_t gehalten = 0;         // Pulse, auf die der vorauslaufende Slave wartete
+
+  // 'anzahl' neue Pulse, der jüngste um 'pulsUs': Sample des Masters
+  uint32_t puls(uint32_t anzahl, int64_t pulsUs, uint32_t periodeUs) {
+    if (anzahl > 1) rueckstand += anzahl - 1;
+    if (!gestartet) {
+      gestartet = true;
+      masterSample = anzahl - 1;
+    } else {
+      uint32_t perioden = anzahl;
+      if (periodeUs > 0 && pulsUs > letzterPulsUs) {
+        const uint32_t ausAbstand = (uint32_t)((pulsUs - letzterPulsUs + periodeUs / 2) / periodeUs);
+        if (ausAbstand > perioden) perioden = ausAbstand;
+      }
+      masterSample += perioden;
+    }
+    letzterPulsUs = pulsUs;
+    return masterSample;
+  }
+
+  // Vor Quellsample 'sample'. warten(anzahl, pulsUs) blockiert bis zum
+  // nächsten Puls; false = Zeitüberschreitung, anzahl = 0 = nichts Neues.
+  // 'periodeUs' ist die Quellperiode des Slaves (gleiche Frequenz wie der Master).
+  template <typename Warten>
+  SyncSchritt schritt(uint32_t sample, uint32_t periodeUs, Warten warten) {
+    while (sample >= naechsterPuls) {
+      uint32_t anzahl = 0;
+      int64_t pulsUs = 0;
+      if (!warten(anzahl, pulsUs)) {
+        naechsterPuls = sample + 1;
+        return SyncSchritt::ZEITUEBERSCHREITUNG;
+      }
+      if (anzahl == 0) continue;
+      const uint32_t master = puls(anzahl, pulsUs, periodeUs);
+      if (master < sample) {
+        gehalten++;
+        continue;
+      }
+      ausgelassen += master - sample;
+      naechsterPuls = master + 1;
+    }
+    return (sample + 1 < naechsterPuls) ? SyncSchritt::AUSLASSEN : SyncSchritt::AUSGEBEN;
+  }
+};
+
+#endif // SYNCNACHFUEHRUNG_HPP
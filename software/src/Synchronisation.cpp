@@ -0,0 +1,140 @@
+#include "Synchronisation.hpp"
+#include "Konfiguration.hpp"
+#include <esp_timer.h>
+
+static SyncModus modus = SyncModus::AUS;
+static TaskHandle_t wartenderTask = nullptr;
+static SyncStatistik statistik;
+static SyncNachfuehrung nachfuehrung;
+static uint32_t verarbeitetePulse = 0;
+// Zähler und Zeitstempel des Pulses gemeinsam lesen
+static portMUX_TYPE pulsSperre = portMUX_INITIALIZER_UNLOCKED;
+
+// Vom Interrupt geschrieben
+static volatile int64_t letzterPulsUs = 0;
+static volatile uint32_t empfangenePulse = 0;
+static volatile uint32_t minPeriodeUs = 0;
+static volatile uint32_t maxPeriodeUs = 0;
+
+static void IRAM_ATTR syncIsr() {
+  int64_t jetzt = esp_timer_get_time();
+  portENTER_CRITICAL_ISR(&pulsSperre);
+  if (empfangenePulse > 0) {
+    uint32_t periode = (uint32_t)(jetzt - letzterPulsUs);
+    if (minPeriodeUs == 0 || periode < minPeriodeUs) minPeriodeUs = periode;
+    if (periode > maxPeriodeUs) maxPeriodeUs = periode;
+  }
+  letzterPulsUs = jetzt;
+  empfangenePulse = empfangenePulse + 1;
+  portEXIT_CRITICAL_ISR(&pulsSperre);
+
+  BaseType_t geweckt = pdFALSE;
+  if (wartenderTask != nullptr) vTaskNotifyGiveFromISR(wartenderTask, &geweckt);
+  if (geweckt) portYIELD_FROM_ISR();
+}
+
+static void konfiguriereLeitung() {
+  detachInterrupt(SYNC_PIN);
+  if (modus == SyncModus::MASTER) {
+    pinMode(SYNC_PIN, OUTPUT);
+    digitalWrite(SYNC_PIN, LOW);
+  } else {
+    // Slave und Einzelbetrieb: hochohmig, damit ein Master treiben kann
+    pinMode(SYNC_PIN, INPUT_PULLDOWN);
+  }
+}
+
+void initSynchronisation() {
+  modus = konfiguration().syncModus;
+  konfiguriereLeitung();
+  if (modus != SyncModus::AUS) Serial.printf("Synchronisation: %s (GPIO %d)\n", syncModusAlsText(modus), SYNC_PIN);
+}
+
+SyncModus syncModus() {
+  return modus;
+}
+
+void setzeSyncModus(SyncModus neu) {
+  modus = neu;
+  konfiguriereLeitung();
+}
+
+SyncModus syncModusAusText(const char* text) {
+  if (text == nullptr) return SyncModus::AUS;
+  if (strcmp(text, "master") == 0) return SyncModus::MASTER;
+  if (strcmp(text, "slave") == 0) return SyncModus::SLAVE;
+  return SyncModus::AUS;
+}
+
+const char* syncModusAlsText(SyncModus m) {
+  switch (m) {
+    case SyncModus::MASTER: return "master";
+    case SyncModus::SLAVE:  return "slave";
+    default:                return "off";
+  }
+}
+
+void syncStart(TaskHandle_t task) {
+  statistik = SyncStatistik();
+  nachfuehrung = SyncNachfuehrung();
+  verarbeitetePulse = 0;
+  empfangenePulse = 0;
+  minPeriodeUs = 0;
+  maxPeriodeUs = 0;
+  if (modus != SyncModus::SLAVE) return;
+  wartenderTask = task;
+  ulTaskNotifyTake(pdTRUE, 0);   // alte Pulse verwerfen
+  attachInterrupt(SYNC_PIN, syncIsr, RISING);
+}
+
+void syncStopp() {
+  if (modus == SyncModus::SLAVE) detachInterrupt(SYNC_PIN);
+  wartenderTask = nullptr;
+}
+
+void syncPulsSenden() {
+  digitalWrite(SYNC_PIN, HIGH);
+  delayMicroseconds(1);
+  digitalWrite(SYNC_PIN, LOW);
+
+  int64_t jetzt = esp_timer_get_time();
+  if (statistik.pulse > 0) {
+    uint32_t periode = (uint32_t)(jetzt - letzterPulsUs);
+    if (minPeriodeUs == 0 || periode < minPeriodeUs) minPeriodeUs = periode;
+    if (periode > maxPeriodeUs) maxPeriodeUs = periode;
+  }
+  letzterPulsUs = jetzt;
+  statistik.pulse++;
+}
+
+SyncSchritt syncWarten(uint32_t sample, uint32_t periodeUs, TickType_t timeout) {
+  SyncSchritt schritt = nachfuehrung.schritt(sample, periodeUs, [&](uint32_t& anzahl, int64_t& pulsUs) {
+    if (ulTaskNotifyTake(pdTRUE, timeout) == 0) return false;
+    // Ein Puls zwischen Benachrichtigung und Lesen zählt schon jetzt; seine
+    // Benachrichtigung liefert dann anzahl = 0
+    portENTER_CRITICAL(&pulsSperre);
+    const uint32_t zaehler = empfangenePulse;
+    pulsUs = letzterPulsUs;
+    portEXIT_CRITICAL(&pulsSperre);
+    anzahl = zaehler - verarbeitetePulse;
+    verarbeitetePulse = zaehler;
+    if (anzahl > 0) {
+      uint32_t latenz = (uint32_t)(esp_timer_get_time() - pulsUs);
+      if (latenz > statistik.maxLatenzUs) statistik.maxLatenzUs = latenz;
+    }
+    return true;
+  });
+  if (schritt == SyncSchritt::ZEITUEBERSCHREITUNG) statistik.ausfaelle++;
+  return schritt;
+}
+
+SyncStatistik holeSyncStatistik() {
+  SyncStatistik s = statistik;
+  if (modus == SyncModus::SLAVE) s.pulse = empfangenePulse;
+  s.rueckstand = nachfuehrung.rueckstand;
+  s.ausgelassen = nachfuehrung.ausgelassen;
+  s.gehalten = nachfuehrung.gehalten;
+  s.minPeriodeUs = minPeriodeUs;
+  s.maxPeriodeUs = maxPeriodeUs;
+  return s;
+}
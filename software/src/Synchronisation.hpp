@@ -0,0 +1,57 @@
+#ifndef SYNCHRONISATION_HPP
+#define SYNCHRONISATION_HPP
+
+#include <Arduino.h>
+#include "PinMapping.hpp"
+#include "SyncNachfuehrung.hpp"
+
+// Gleichlauf mehrerer Simulatoren über eine gemeinsame Sync-Leitung (SYNC_PIN):
+//   MASTER: sendet vor jedem Quellsample einen kurzen Puls
+//   SLAVE:  gibt jedes Quellsample erst auf den Puls hin aus (Puls = Abtasttakt)
+// Koordinierter Start: Slaves mit /play scharf schalten, dann den Master starten.
+// Alle Geräte brauchen dieselbe Ausgabefrequenz; ohne Pulse beendet der Slave
+// die Wiedergabe nach SYNC_MAX_AUSFAELLE verpassten Perioden. Rückstand und
+// verlorene Pulse holt der Slave durch Auslassen von Quellsamples auf
+// (SyncNachfuehrung.hpp).
+
+#define SYNC_MAX_AUSFAELLE     3
+#define SYNC_START_TIMEOUT_MS  60000
+
+enum class SyncModus : uint8_t { AUS, MASTER, SLAVE };
+
+struct SyncStatistik {
+  uint32_t pulse = 0;            // empfangene bzw. gesendete Pulse
+  uint32_t ausfaelle = 0;        // Slave: Zeitüberschreitungen
+  uint32_t rueckstand = 0;       // Slave: Pulse, die während der Ausgabe aufliefen
+  uint32_t ausgelassen = 0;      // Slave: zum Aufholen übersprungene Quellsamples
+  uint32_t gehalten = 0;         // Slave: nach Ausfällen auf den Master gewartet
+  uint32_t maxLatenzUs = 0;      // Slave: Puls bis Frame-Beginn
+  uint32_t minPeriodeUs = 0;
+  uint32_t maxPeriodeUs = 0;
+};
+
+// Übernimmt den Modus aus der Konfiguration und konfiguriert die Leitung
+void initSynchronisation();
+
+SyncModus syncModus();
+// Wendet einen Modus an (gespeichert wird er mit der Konfiguration);
+// nicht während der Wiedergabe umschalten
+void setzeSyncModus(SyncModus modus);
+SyncModus syncModusAusText(const char* text);
+const char* syncModusAlsText(SyncModus modus);
+
+// Beginn/Ende einer Wiedergabe (Slave: Interrupt an den Task binden)
+void syncStart(TaskHandle_t task);
+void syncStopp();
+
+// Master: Puls vor dem Frame
+void syncPulsSenden();
+
+// Slave: vor Quellsample 'sample' (ab 0 seit dem Start) auf den Puls warten.
+// AUSLASSEN = Sample überspringen, der Master ist schon weiter;
+// ZEITUEBERSCHREITUNG = kein Puls innerhalb von 'timeout'
+SyncSchritt syncWarten(uint32_t sample, uint32_t periodeUs, TickType_t timeout);
+
+SyncStatistik holeSyncStatistik();
+
+#endif // SYNCHRONISATION_HPP
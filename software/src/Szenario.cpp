@@ -0,0 +1,302 @@
+#include "Szenario.hpp"
+#include "Server.hpp"
+#include "Spannungswandlung.hpp"
+#include "DacRouting.hpp"
+#include "TaskTopologie.hpp"
+#include "Konfiguration.hpp"
+#include <SPIFFS.h>
+#include <ArduinoJson.h>
+
+static std::vector<SegmentBeschreibung> beschreibungen;
+static bool szenarioWiederholen = false;
+
+// Doppelpuffer: einer spielt, der andere wird vorgeladen
+static KanalTabelle segmentTabelle[2];
+static size_t segmentLaenge[2] = {};          // 0 = Szenarioende
+static size_t segmentIndex[2] = {};
+static uint8_t ladePuffer = 0;                // wird als nächstes gefüllt
+static size_t naechsteBeschreibung = 0;
+
+static SemaphoreHandle_t segmentBereit = nullptr;
+static TaskHandle_t vorladeTaskHandle = nullptr;
+static volatile bool szenarioLaeuft = false;
+static volatile bool abbruchAngefordert = false;
+static float abtastrateHz = 100.0f;           // Quelltakt beim Szenariostart
+
+static SzenarioStatus status;
+static size_t gelieferteSegmente = 0;
+
+bool leseSzenario(const String& pfad, std::vector<SegmentBeschreibung>& segmente, bool& wiederholen, String& fehler) {
+  segmente.clear();
+  File file = SPIFFS.open(pfad, "r");
+  if (!file) {
+    fehler = "Szenario nicht gefunden: " + pfad;
+    return false;
+  }
+  JsonDocument doc;
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+  if (err) {
+    fehler = "Ungültiges JSON: " + String(err.c_str());
+    return false;
+  }
+
+  JsonArray liste = doc["segments"];
+  if (liste.isNull() || liste.size() == 0) {
+    fehler = "Feld 'segments' fehlt oder ist leer";
+    return false;
+  }
+  wiederholen = doc["loop"] | false;
+
+  for (JsonObject e : liste) {
+    SegmentBeschreibung s;
+    String nr = "Segment " + String(segmente.size() + 1) + ": ";
+    String typ = e["type"] | "";
+    s.dauerS = e["duration"] | 0.0f;
+    int wiederholungen = e["repeat"] | 1;
+    s.schleife = e["loop"] | false;
+    s.bereich.modus = bereichsModusAusText(e["range"] | "fixed");
+    s.bereich.minMv = e["min"] | STANDARD_MIN_MV;
+    s.bereich.maxMv = e["max"] | STANDARD_MAX_MV;
+
+    if (!isfinite(s.dauerS) || s.dauerS < 0.0f) {
+      fehler = nr + "ungültige Dauer";
+      return false;
+    }
+    if (wiederholungen < 1 || wiederholungen > 65535) {
+      fehler = nr + "ungültige Wiederholungszahl";
+      return false;
+    }
+    s.wiederholungen = (uint16_t)wiederholungen;
+
+    if (typ == "file") {
+      s.typ = SegmentTyp::DATEI;
+      size_t anzahl = 0;
+      for (JsonPair p : e["files"].as<JsonObject>()) {
+        int kanal = kanalIndexAusName(String(p.key().c_str()));
+        if (kanal < 0) {
+          fehler = nr + "unbekannter Kanal " + String(p.key().c_str());
+          return false;
+        }
+        String datei = "/" + String(p.value() | "");
+        if (!signaldateiVorhanden(datei)) {
+          fehler = nr + "Datei nicht gefunden: " + datei;
+          return false;
+        }
+        s.dateien[kanal] = datei;
+        anzahl++;
+      }
+      if (anzahl == 0) {
+        fehler = nr + "keine Dateien angegeben";
+        return false;
+      }
+    } else if (typ == "sine") {
+      s.typ = SegmentTyp::SINUS;
+      s.frequenzHz = e["frequency"] | 10.0f;
+      s.amplitudeMv = e["amplitude"] | 0.0f;
+      if (!isfinite(s.frequenzHz) || s.frequenzHz < 0.0f || !isfinite(s.amplitudeMv)) {
+        fehler = nr + "ungültige Generatorparameter";
+        return false;
+      }
+      JsonArray kanaele = e["channels"];
+      for (int kanal = 0; kanal < ANZAHL_KANAELE; ++kanal) s.sinusKanal[kanal] = kanaele.isNull();
+      for (JsonVariant name : kanaele) {
+        int kanal = kanalIndexAusName(String(name | ""));
+        if (kanal < 0) {
+          fehler = nr + "unbekannter Kanal";
+          return false;
+        }
+        s.sinusKanal[kanal] = true;
+      }
+    } else if (typ == "silence") {
+      s.typ = SegmentTyp::STILLE;
+    } else {
+      fehler = nr + "unbekannter Typ '" + typ + "'";
+      return false;
+    }
+
+    if (s.typ != SegmentTyp::DATEI && s.dauerS <= 0.0f) {
+      fehler = nr + "Dauer fehlt";
+      return false;
+    }
+    segmente.push_back(std::move(s));
+  }
+  return true;
+}
+
+// Ladepuffer in mV, über die Segmente hinweg wiederverwendet (nur der Vorlade-Task)
+static std::vector<float> werte;
+
+// Setzt einen Kanal zurück, behält aber die Kapazität seiner Vektoren: wiederholte
+// und ähnlich lange Segmente kommen ohne neue Heap-Anforderung aus
+static void leereKanal(Kanal& kanal) {
+  std::vector<Q15> samples = std::move(kanal.samples);
+  std::vector<Marker> marker = std::move(kanal.marker);
+  samples.clear();
+  marker.clear();
+  kanal = Kanal();
+  kanal.samples = std::move(samples);
+  kanal.marker = std::move(marker);
+}
+
+// Lädt die Samples eines Segments und legt die Skalierung fest; liefert die Länge in Samples
+static size_t ladeSegment(const SegmentBeschreibung& s, KanalTabelle& tabelle) {
+  for (Kanal& kanal : tabelle) leereKanal(kanal);
+
+  size_t laengste = 0;
+  for (int index = 0; index < ANZAHL_KANAELE; ++index) {
+    Kanal& kanal = tabelle[index];
+    werte.clear();
+    if (s.typ == SegmentTyp::DATEI && s.dateien[index].length() > 0) {
+      SignalLadeInfo info;
+      if (!ladeSignaldatei(s.dateien[index], werte, info) || werte.empty()) {
+        Serial.println("⚠️ Szenario: keine Samples in " + s.dateien[index]);
+        werte.clear();
+      }
+      ladeMarkerDatei(markerPfad(s.dateien[index]), kanal.marker);
+      setzeMarkerRate(kanal.marker, abtastrateHz);
+      kanal.schleife = s.schleife || s.wiederholungen > 1;
+      if (werte.size() > laengste) laengste = werte.size();
+    } else if (s.typ == SegmentTyp::SINUS && s.sinusKanal[index]) {
+      kanal.sinus.frequenzHz = s.frequenzHz;
+      kanal.sinus.amplitudeMv = s.amplitudeMv;
+    }
+
+    float minMv = s.bereich.minMv;
+    float maxMv = s.bereich.maxMv;
+    if (s.bereich.modus == BereichsModus::AUTO) {
+      if (!werte.empty()) {
+        bestimmeBereich(werte.data(), werte.size(), minMv, maxMv);
+      } else {
+        minMv = -fabsf(kanal.sinus.amplitudeMv);
+        maxMv = fabsf(kanal.sinus.amplitudeMv);
+      }
+    }
+    kanal.skalierung = berechneSkalierung(s.bereich.modus, minMv, maxMv);
+    kanal.samples.resize(werte.size());
+    normiereBlock(werte.data(), werte.size(), kanal.skalierung, kanal.samples.data());
+    kanal.sinus.amplitude = amplitudeAlsQ15(kanal.sinus.amplitudeMv, kanal.skalierung);
+  }
+
+  if (s.dauerS > 0.0f) return (size_t)lroundf(s.dauerS * abtastrateHz);
+  return laengste * s.wiederholungen;
+}
+
+// Core 0: lädt auf Anforderung das nächste Segment in den freien Puffer
+static void vorladeTask(void* parameter) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (!szenarioLaeuft) break;
+
+    size_t laenge = 0;
+    // Leere Segmente (z. B. ohne Samples) überspringen, höchstens ein Durchgang
+    for (size_t versuch = 0; laenge == 0 && versuch < beschreibungen.size(); ++versuch) {
+      if (naechsteBeschreibung >= beschreibungen.size()) {
+        if (!szenarioWiederholen) break;
+        naechsteBeschreibung = 0;
+      }
+      segmentIndex[ladePuffer] = naechsteBeschreibung;
+      laenge = ladeSegment(beschreibungen[naechsteBeschreibung++], segmentTabelle[ladePuffer]);
+    }
+    segmentLaenge[ladePuffer] = laenge;
+    xSemaphoreGive(segmentBereit);
+  }
+
+  for (KanalTabelle& tabelle : segmentTabelle) {
+    for (Kanal& kanal : tabelle) kanal = Kanal();
+  }
+  std::vector<float>().swap(werte);
+  vorladeTaskHandle = nullptr;
+  vTaskDelete(nullptr);
+}
+
+bool starteSzenario(const String& pfad, String& fehler) {
+  // Bis szenarioLaeuft gesetzt ist, darf kein Trigger eine normale Wiedergabe armieren
+  if (vorladeTaskHandle != nullptr || !sperreKanalTabelle()) {
+    fehler = "Wiedergabe läuft bereits";
+    return false;
+  }
+  std::vector<SegmentBeschreibung> segmente;
+  bool wiederholen = false;
+  if (!leseSzenario(pfad, segmente, wiederholen, fehler)) {
+    gibKanalTabelleFrei();
+    return false;
+  }
+
+  beschreibungen = std::move(segmente);
+  szenarioWiederholen = wiederholen;
+  if (segmentBereit == nullptr) segmentBereit = xSemaphoreCreateBinary();
+  xSemaphoreTake(segmentBereit, 0);
+  ladePuffer = 0;
+  naechsteBeschreibung = 0;
+  gelieferteSegmente = 0;
+  status = SzenarioStatus();
+  status.laeuft = true;
+  status.segmentAnzahl = beschreibungen.size();
+  abbruchAngefordert = false;
+  abtastrateHz = ausgabeFrequenzHz;
+  szenarioLaeuft = true;
+
+  xTaskCreatePinnedToCore(vorladeTask, "VorladeTask", VORLADE_TASK_STACK, nullptr,
+                          konfiguration().vorladePrio, &vorladeTaskHandle, VORLADE_TASK_CORE);
+  xTaskNotifyGive(vorladeTaskHandle);   // erstes Segment laden
+  gibKanalTabelleFrei();
+  starteWiedergabe();
+  Serial.printf("Szenario %s gestartet (%u Segmente)\n", pfad.c_str(), (unsigned)beschreibungen.size());
+  return true;
+}
+
+bool szenarioAktiv() {
+  return szenarioLaeuft;
+}
+
+float szenarioAbtastrate() {
+  return abtastrateHz;
+}
+
+bool szenarioAbgebrochen() {
+  return abbruchAngefordert;
+}
+
+void stoppeSzenario() {
+  abbruchAngefordert = true;
+}
+
+bool szenarioNutztKanal(uint8_t index) {
+  for (const SegmentBeschreibung& s : beschreibungen) {
+    if (s.dateien[index].length() > 0 || s.sinusKanal[index]) return true;
+  }
+  return false;
+}
+
+bool szenarioNaechstesSegment(const KanalTabelle*& tabelle, size_t& laenge) {
+  if (!szenarioLaeuft || abbruchAngefordert) return false;
+  if (xSemaphoreTake(segmentBereit, 0) != pdTRUE) {
+    // Vorladen langsamer als das laufende Segment: Wiedergabe wartet
+    if (gelieferteSegmente > 0) status.unterlaeufe++;
+    xSemaphoreTake(segmentBereit, portMAX_DELAY);
+  }
+  const uint8_t fertig = ladePuffer;
+  if (segmentLaenge[fertig] == 0) return false;
+
+  if (gelieferteSegmente > 0 && segmentIndex[fertig] <= status.aktuellesSegment) status.durchlaeufe++;
+  status.aktuellesSegment = segmentIndex[fertig];
+  gelieferteSegmente++;
+
+  tabelle = &segmentTabelle[fertig];
+  laenge = segmentLaenge[fertig];
+  // Der zuvor gespielte Puffer ist frei: nächstes Segment vorladen
+  ladePuffer ^= 1;
+  xTaskNotifyGive(vorladeTaskHandle);
+  return true;
+}
+
+void beendeSzenario() {
+  szenarioLaeuft = false;
+  status.laeuft = false;
+  if (vorladeTaskHandle != nullptr) xTaskNotifyGive(vorladeTaskHandle);
+}
+
+SzenarioStatus holeSzenarioStatus() {
+  return status;
+}
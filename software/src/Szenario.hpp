@@ -0,0 +1,64 @@
+#ifndef SZENARIO_HPP
+#define SZENARIO_HPP
+
+#include <Arduino.h>
+#include <vector>
+#include "Global_Var.hpp"
+#include "PinMapping.hpp"
+
+// Szenario-Wiedergabe: eine JSON-Beschreibung im SPIFFS legt eine Folge von
+// Segmenten fest (Aufnahmen, Generatoren, Pausen). Ein Vorlade-Task auf Core 0
+// lädt das nächste Segment, während das aktuelle spielt; der Abspiel-Task
+// wechselt am Segmentende nur noch die Tabelle (samplegenau, ohne Lücke).
+//
+// Beispiel:
+// {"loop":false,"segments":[
+//   {"type":"file","files":{"CH_A":"x.txt","CH_B":"x2.txt"},"duration":30},
+//   {"type":"sine","channels":["CH_A","CH_B"],"frequency":10,"amplitude":50,"duration":10},
+//   {"type":"file","files":{"CH_A":"y.txt"},"repeat":3},
+//   {"type":"silence","duration":2}]}
+// Optional pro Segment: "range" ("fixed"/"auto"/"user") mit "min"/"max".
+
+enum class SegmentTyp : uint8_t { DATEI, SINUS, STILLE };
+
+struct SegmentBeschreibung {
+  SegmentTyp typ = SegmentTyp::STILLE;
+  float dauerS = 0.0f;               // 0 = Dateilänge * Wiederholungen
+  uint16_t wiederholungen = 1;
+  bool schleife = false;             // Dateien innerhalb der Dauer wiederholen
+  String dateien[ANZAHL_KANAELE];    // DATEI: Pfad pro Kanal, leer = 0 mV
+  bool sinusKanal[ANZAHL_KANAELE] = {};  // SINUS: beteiligte Kanäle
+  float frequenzHz = 0.0f;
+  float amplitudeMv = 0.0f;
+  KanalSkalierung bereich;           // gewünschter Modus mit min/max
+};
+
+struct SzenarioStatus {
+  bool laeuft = false;
+  size_t segmentAnzahl = 0;
+  size_t aktuellesSegment = 0;       // Index in der Beschreibung
+  uint32_t durchlaeufe = 0;          // abgeschlossene Wiederholungen bei "loop"
+  uint32_t unterlaeufe = 0;          // Segmentwechsel, bei denen das Vorladen noch lief
+};
+
+// Liest und prüft die Beschreibung (ohne Samples zu laden)
+bool leseSzenario(const String& pfad, std::vector<SegmentBeschreibung>& segmente, bool& wiederholen, String& fehler);
+
+// Startet Vorlade- und Abspiel-Task für das Szenario
+bool starteSzenario(const String& pfad, String& fehler);
+
+// Beendet die Wiedergabe am nächsten Block
+void stoppeSzenario();
+
+// Aufrufe aus dem Abspiel-Task
+bool szenarioAktiv();
+bool szenarioAbgebrochen();
+// Quelltakt beim Szenariostart; Segmentdauer und Marker beziehen sich darauf
+float szenarioAbtastrate();
+bool szenarioNutztKanal(uint8_t index);
+bool szenarioNaechstesSegment(const KanalTabelle*& tabelle, size_t& laenge);
+void beendeSzenario();
+
+SzenarioStatus holeSzenarioStatus();
+
+#endif // SZENARIO_HPP
@@ -0,0 +1,41 @@
+#ifndef TAKT_HPP
+#define TAKT_HPP
+
+#include <stdint.h>
+
+// Fristen des Ausgabetakts in µs mit 32 Bit Nachkommastellen: auch gebrochene
+// Perioden (1951.2195 µs bei 512.5 Hz) summieren sich ohne Rundungsdrift.
+// Ohne Arduino-Abhängigkeit (Host-Test test/test_takt); geschlafen wird in
+// Spannungswandlung.cpp.
+struct Takt {
+  int64_t fristUs = 0;
+  uint32_t fristBruch = 0;
+  uint32_t periodeUs = 0;
+  uint32_t periodeBruch = 0;
+};
+
+static inline void setzePeriode(Takt& takt, float hz) {
+  const uint64_t periode = (uint64_t)(1e6 * 4294967296.0 / hz);
+  takt.periodeUs = (uint32_t)(periode >> 32);
+  takt.periodeBruch = (uint32_t)periode;
+}
+
+static inline void naechsteFrist(Takt& takt) {
+  const uint64_t bruch = (uint64_t)takt.fristBruch + takt.periodeBruch;
+  takt.fristBruch = (uint32_t)bruch;
+  takt.fristUs += takt.periodeUs + (int64_t)(bruch >> 32);
+}
+
+// Zeit bis zur Frist (<= 0: sofort schreiben). Liegt sie mehr als eine
+// Periode zurück (z. B. nach einer langen Blockumrechnung), wird neu
+// aufgesetzt statt Frames nachzuholen
+static inline int64_t restBisFrist(Takt& takt, int64_t jetztUs) {
+  const int64_t rest = takt.fristUs - jetztUs;
+  if (rest <= 0 && -rest > (int64_t)takt.periodeUs) {
+    takt.fristUs -= rest;
+    takt.fristBruch = 0;
+  }
+  return rest;
+}
+
+#endif // TAKT_HPP
@@ -0,0 +1,76 @@
+#include "TaskTopologie.hpp"
+
+extern TaskHandle_t abspielTaskHandle;
+
+#if configUSE_TRACE_FACILITY
+
+static TaskStatus_t taskStatus[TASK_INFO_MAX];
+
+#if configGENERATE_RUN_TIME_STATS
+// Laufzeitzähler der letzten Abfrage, für Anteile seit dann statt seit dem Booten
+struct Laufzeit {
+  TaskHandle_t task;
+  uint32_t zaehler;
+};
+static Laufzeit vorher[TASK_INFO_MAX];
+static size_t vorherAnzahl = 0;
+static uint32_t vorherGesamt = 0;
+#endif
+
+size_t erfasseTasks(TaskInfo* ziel, size_t maxAnzahl) {
+  uint32_t gesamt = 0;
+  UBaseType_t anzahl = uxTaskGetSystemState(taskStatus, TASK_INFO_MAX, &gesamt);
+  if (anzahl > maxAnzahl) anzahl = maxAnzahl;
+
+  for (UBaseType_t i = 0; i < anzahl; ++i) {
+    const TaskStatus_t& s = taskStatus[i];
+    TaskInfo& t = ziel[i];
+    t = TaskInfo();
+    strncpy(t.name, s.pcTaskName, sizeof(t.name) - 1);
+#if configTASKLIST_INCLUDE_COREID
+    t.core = (s.xCoreID == tskNO_AFFINITY) ? -1 : (int8_t)s.xCoreID;
+#endif
+    t.prioritaet = (uint8_t)s.uxCurrentPriority;
+    t.stackFreiBytes = s.usStackHighWaterMark;   // ESP-IDF zählt in Bytes
+#if configGENERATE_RUN_TIME_STATS
+    const uint32_t gesamtDelta = gesamt - vorherGesamt;
+    for (size_t j = 0; j < vorherAnzahl && gesamtDelta > 0; ++j) {
+      if (vorher[j].task == s.xHandle) {
+        t.cpuProzent = 100.0f * (s.ulRunTimeCounter - vorher[j].zaehler) / gesamtDelta;
+        break;
+      }
+    }
+#endif
+  }
+
+#if configGENERATE_RUN_TIME_STATS
+  vorherAnzahl = anzahl;
+  for (UBaseType_t i = 0; i < anzahl; ++i) {
+    vorher[i].task = taskStatus[i].xHandle;
+    vorher[i].zaehler = taskStatus[i].ulRunTimeCounter;
+  }
+  vorherGesamt = gesamt;
+#endif
+  return anzahl;
+}
+
+#else
+
+// Ohne Trace-Facility: nur der Abspiel-Task und der aufrufende Task
+static void erfasseEinzeln(TaskHandle_t task, TaskInfo& t) {
+  t = TaskInfo();
+  strncpy(t.name, pcTaskGetName(task), sizeof(t.name) - 1);
+  BaseType_t core = xTaskGetAffinity(task);
+  t.core = (core == tskNO_AFFINITY) ? -1 : (int8_t)core;
+  t.prioritaet = (uint8_t)uxTaskPriorityGet(task);
+  t.stackFreiBytes = uxTaskGetStackHighWaterMark(task);
+}
+
+size_t erfasseTasks(TaskInfo* ziel, size_t maxAnzahl) {
+  size_t anzahl = 0;
+  if (abspielTaskHandle != nullptr && anzahl < maxAnzahl) erfasseEinzeln(abspielTaskHandle, ziel[anzahl++]);
+  if (anzahl < maxAnzahl) erfasseEinzeln(xTaskGetCurrentTaskHandle(), ziel[anzahl++]);
+  return anzahl;
+}
+
+#endif
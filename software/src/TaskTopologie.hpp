@@ -0,0 +1,62 @@
+#ifndef TASKTOPOLOGIE_HPP
+#define TASKTOPOLOGIE_HPP
+
+#include <Arduino.h>
+
+// Aufteilung der Tasks auf die beiden Kerne:
+//   Core 1: Abspiel-Task (höchste Anwendungspriorität, frei von WLAN-Last),
+//           daneben nur loop() mit Priorität 1
+//   Core 0: WLAN/LwIP, AsyncTCP (Webserver, Parsen in /processFiles; siehe
+//           CONFIG_ASYNC_TCP_* in platformio.ini), der Vorlade-Task und
+//           beim Booten die Start-Tasks
+// Alle Werte lassen sich per Build-Flag überschreiben, z. B. -DABSPIEL_TASK_STACK=6144
+// Die Prioritäten von Abspiel- und Vorlade-Task sind nur Standardwerte der
+// Konfiguration (Konfiguration.hpp, POST /config).
+
+#ifndef ABSPIEL_TASK_CORE
+#define ABSPIEL_TASK_CORE   1
+#endif
+#ifndef ABSPIEL_TASK_PRIO
+#define ABSPIEL_TASK_PRIO   5
+#endif
+// Der Abspiel-Task ruft Serial.printf mit %f (newlib) und std::stable_sort
+// auf; freier Rest: GET /tasks -> stackFreeBytes bzw. Log nach jeder Wiedergabe
+#ifndef ABSPIEL_TASK_STACK
+#define ABSPIEL_TASK_STACK  8192
+#endif
+
+#ifndef VORLADE_TASK_CORE
+#define VORLADE_TASK_CORE   0
+#endif
+#ifndef VORLADE_TASK_PRIO
+#define VORLADE_TASK_PRIO   1
+#endif
+#ifndef VORLADE_TASK_STACK
+#define VORLADE_TASK_STACK  8192
+#endif
+
+// Kurzlebige Start-Tasks (Dateisystem, WLAN/Webserver), siehe Bootablauf.hpp
+#ifndef BOOT_TASK_CORE
+#define BOOT_TASK_CORE      0
+#endif
+#ifndef BOOT_TASK_PRIO
+#define BOOT_TASK_PRIO      2
+#endif
+#ifndef BOOT_TASK_STACK
+#define BOOT_TASK_STACK     8192
+#endif
+
+#define TASK_INFO_MAX       32
+
+struct TaskInfo {
+  char name[configMAX_TASK_NAME_LEN] = {};
+  int8_t core = -1;               // -1 = nicht gebunden
+  uint8_t prioritaet = 0;
+  uint32_t stackFreiBytes = 0;    // kleinster freier Stack seit Taskstart
+  float cpuProzent = -1.0f;       // Anteil an einem Kern seit der letzten Abfrage, -1 = unbekannt
+};
+
+// Erfasst alle Tasks; CPU-Anteile nur mit FreeRTOS-Laufzeitstatistik
+size_t erfasseTasks(TaskInfo* ziel, size_t maxAnzahl);
+
+#endif // TASKTOPOLOGIE_HPP
@@ -0,0 +1,111 @@
+#include "Trigger.hpp"
+#include "Spannungswandlung.hpp"
+#include "Konfiguration.hpp"
+#include <esp_timer.h>
+
+static TriggerEinstellung einstellung;
+static TriggerStatistik statistik;
+static volatile int64_t letzteFlankeUs = 0;
+static portMUX_TYPE statistikSperre = portMUX_INITIALIZER_UNLOCKED;
+
+static void IRAM_ATTR triggerIsr() {
+  int64_t jetzt = esp_timer_get_time();
+  portENTER_CRITICAL_ISR(&statistikSperre);
+  const bool entprellt = (jetzt - letzteFlankeUs < (int64_t)einstellung.entprellUs);
+  if (entprellt) statistik.verworfen++;
+  else statistik.ausloesungen++;
+  portEXIT_CRITICAL_ISR(&statistikSperre);
+  if (entprellt) return;
+  letzteFlankeUs = jetzt;
+
+  // Keine switch-Sprungtabelle: die läge im Flash
+  BaseType_t geweckt = pdFALSE;
+  const TriggerAktion aktion = einstellung.aktion;
+  if (aktion == TriggerAktion::START) wiedergabeStartenAusIsr(jetzt, &geweckt);
+  else if (aktion == TriggerAktion::STOPP) wiedergabeStoppenAusIsr(&geweckt);
+  else if (aktion == TriggerAktion::UMSCHALTEN) wiedergabeUmschaltenAusIsr(jetzt, &geweckt);
+  else if (aktion == TriggerAktion::WEITER) wiedergabeWeiterAusIsr();
+  if (geweckt) portYIELD_FROM_ISR();
+}
+
+static void bindeInterrupt() {
+  detachInterrupt(TRIGGER_PIN);
+  pinMode(TRIGGER_PIN, INPUT_PULLDOWN);
+  if (einstellung.aktion == TriggerAktion::AUS) return;
+  int modus = RISING;
+  if (einstellung.flanke == TriggerFlanke::FALLEND) modus = FALLING;
+  if (einstellung.flanke == TriggerFlanke::BEIDE) modus = CHANGE;
+  attachInterrupt(TRIGGER_PIN, triggerIsr, modus);
+}
+
+void initTrigger() {
+  einstellung = konfiguration().trigger;
+  bindeInterrupt();
+  if (einstellung.aktion != TriggerAktion::AUS) {
+    Serial.printf("Trigger-Eingang GPIO %d: %s, Flanke %s\n", TRIGGER_PIN,
+                  triggerAktionAlsText(einstellung.aktion), triggerFlankeAlsText(einstellung.flanke));
+  }
+}
+
+void setzeTriggerEinstellung(const TriggerEinstellung& neu) {
+  detachInterrupt(TRIGGER_PIN);
+  einstellung = neu;
+  portENTER_CRITICAL(&statistikSperre);
+  statistik = TriggerStatistik();
+  portEXIT_CRITICAL(&statistikSperre);
+  bindeInterrupt();
+}
+
+TriggerEinstellung holeTriggerEinstellung() {
+  return einstellung;
+}
+
+TriggerStatistik holeTriggerStatistik() {
+  portENTER_CRITICAL(&statistikSperre);
+  TriggerStatistik s = statistik;
+  portEXIT_CRITICAL(&statistikSperre);
+  return s;
+}
+
+void meldeTriggerLatenz(uint32_t latenzUs) {
+  portENTER_CRITICAL(&statistikSperre);
+  if (statistik.latenzAnzahl == 0 || latenzUs < statistik.minLatenzUs) statistik.minLatenzUs = latenzUs;
+  if (latenzUs > statistik.maxLatenzUs) statistik.maxLatenzUs = latenzUs;
+  statistik.summeLatenzUs += latenzUs;
+  statistik.latenzAnzahl++;
+  portEXIT_CRITICAL(&statistikSperre);
+}
+
+TriggerAktion triggerAktionAusText(const char* text) {
+  if (text == nullptr) return TriggerAktion::AUS;
+  if (strcmp(text, "start") == 0) return TriggerAktion::START;
+  if (strcmp(text, "stop") == 0) return TriggerAktion::STOPP;
+  if (strcmp(text, "toggle") == 0) return TriggerAktion::UMSCHALTEN;
+  if (strcmp(text, "advance") == 0) return TriggerAktion::WEITER;
+  return TriggerAktion::AUS;
+}
+
+const char* triggerAktionAlsText(TriggerAktion aktion) {
+  switch (aktion) {
+    case TriggerAktion::START:      return "start";
+    case TriggerAktion::STOPP:      return "stop";
+    case TriggerAktion::UMSCHALTEN: return "toggle";
+    case TriggerAktion::WEITER:     return "advance";
+    default:                        return "off";
+  }
+}
+
+TriggerFlanke triggerFlankeAusText(const char* text) {
+  if (text == nullptr) return TriggerFlanke::STEIGEND;
+  if (strcmp(text, "falling") == 0) return TriggerFlanke::FALLEND;
+  if (strcmp(text, "both") == 0) return TriggerFlanke::BEIDE;
+  return TriggerFlanke::STEIGEND;
+}
+
+const char* triggerFlankeAlsText(TriggerFlanke flanke) {
+  switch (flanke) {
+    case TriggerFlanke::FALLEND: return "falling";
+    case TriggerFlanke::BEIDE:   return "both";
+    default:                     return "rising";
+  }
+}
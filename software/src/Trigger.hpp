@@ -0,0 +1,53 @@
+#ifndef TRIGGER_HPP
+#define TRIGGER_HPP
+
+#include <Arduino.h>
+#include "PinMapping.hpp"
+
+// Hardware-Trigger am Eingang TRIGGER_PIN: der Interrupt startet, stoppt oder
+// schaltet die Wiedergabe weiter, ohne Umweg über WLAN und Webserver.
+// Für die kürzeste Latenz die Wiedergabe vorher armieren (/arm).
+
+enum class TriggerAktion : uint8_t { AUS, START, STOPP, UMSCHALTEN, WEITER };
+enum class TriggerFlanke : uint8_t { STEIGEND, FALLEND, BEIDE };
+
+#define TRIGGER_MAX_ENTPRELL_US  1000000
+
+// Teil der Konfiguration (Konfiguration.hpp)
+struct TriggerEinstellung {
+  TriggerAktion aktion = TriggerAktion::AUS;
+  TriggerFlanke flanke = TriggerFlanke::STEIGEND;
+  uint32_t entprellUs = 2000;     // Flanken innerhalb dieser Zeit werden verworfen
+
+  bool operator==(const TriggerEinstellung& o) const {
+    return aktion == o.aktion && flanke == o.flanke && entprellUs == o.entprellUs;
+  }
+  bool operator!=(const TriggerEinstellung& o) const { return !(*this == o); }
+};
+
+struct TriggerStatistik {
+  uint32_t ausloesungen = 0;
+  uint32_t verworfen = 0;         // durch die Entprellung
+  uint32_t latenzAnzahl = 0;      // Starts mit gemessener Latenz
+  uint32_t minLatenzUs = 0;       // Flanke bis erste DAC-Übernahme
+  uint32_t maxLatenzUs = 0;
+  uint64_t summeLatenzUs = 0;
+};
+
+// Übernimmt die Einstellung aus der Konfiguration und bindet den Interrupt
+void initTrigger();
+
+// Wendet eine Einstellung an (gespeichert wird sie mit der Konfiguration)
+void setzeTriggerEinstellung(const TriggerEinstellung& einstellung);
+TriggerEinstellung holeTriggerEinstellung();
+TriggerStatistik holeTriggerStatistik();
+
+// Vom Abspiel-Task nach der ersten DAC-Übernahme eines Trigger-Starts
+void meldeTriggerLatenz(uint32_t latenzUs);
+
+TriggerAktion triggerAktionAusText(const char* text);
+const char* triggerAktionAlsText(TriggerAktion aktion);
+TriggerFlanke triggerFlankeAusText(const char* text);
+const char* triggerFlankeAlsText(TriggerFlanke flanke);
+
+#endif // TRIGGER_HPP
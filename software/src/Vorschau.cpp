@@ -0,0 +1,114 @@
+#include "Vorschau.hpp"
+#include "Server.hpp"
+#include "Kompression.hpp"
+#include <SPIFFS.h>
+
+// Verteilt die Samples eines Bereichs auf die Abschnitte; Grenzen werden
+// schrittweise weitergezählt statt pro Sample zu dividieren
+class Abschnitte {
+public:
+  Abschnitte(Vorschau& v, uint16_t punkte) : v(v) {
+    laenge = v.bis - v.von;
+    anzahl = laenge < punkte ? laenge : punkte;
+    v.minMv.assign(anzahl, INFINITY);
+    v.maxMv.assign(anzahl, -INFINITY);
+    grenze = naechsteGrenze();
+  }
+
+  inline void nimm(uint32_t i, float wert) {
+    if (i < v.von || i >= v.bis) return;
+    while (i >= grenze) {
+      index++;
+      grenze = naechsteGrenze();
+    }
+    if (wert < v.minMv[index]) v.minMv[index] = wert;
+    if (wert > v.maxMv[index]) v.maxMv[index] = wert;
+  }
+
+private:
+  uint32_t naechsteGrenze() const {
+    return v.von + (uint32_t)((uint64_t)(index + 1) * laenge / anzahl);
+  }
+
+  Vorschau& v;
+  uint32_t laenge = 0;
+  uint32_t anzahl = 0;
+  uint32_t index = 0;
+  uint32_t grenze = 0;
+};
+
+static bool setzeBereich(Vorschau& v, uint32_t von, uint32_t bis, String& fehler) {
+  if (bis == 0 || bis > v.sampleAnzahl) bis = v.sampleAnzahl;
+  if (von >= bis) {
+    fehler = "Leerer Bereich (Datei hat " + String(v.sampleAnzahl) + " Samples)";
+    return false;
+  }
+  v.von = von;
+  v.bis = bis;
+  return true;
+}
+
+// Dekodiert nur die Blöcke, die [von, bis) überdecken; sie liegen hintereinander,
+// daher genügt ein Sprung über die Offset-Tabelle
+static bool vorschauAusCache(File& f, uint32_t von, uint32_t bis, uint16_t punkte, Vorschau& v, String& fehler) {
+  KompressionsHeader h;
+  uint8_t kopf[sizeof(KompressionsHeader)];
+  if (f.read(kopf, sizeof(kopf)) != sizeof(kopf) || !pruefeKompressionsHeader(kopf, sizeof(kopf), h)) {
+    fehler = "Cache beschädigt";
+    return false;
+  }
+  v.sampleAnzahl = h.sampleAnzahl;
+  if (!setzeBereich(v, von, bis, fehler)) return false;
+  Abschnitte abschnitte(v, punkte);
+
+  const uint32_t ersterBlock = v.von / h.blockGroesse;
+  const uint32_t letzterBlock = (v.bis - 1) / h.blockGroesse;
+  const size_t tabelleEnde = sizeof(h) + (size_t)h.blockAnzahl * sizeof(uint32_t);
+  uint32_t offset = 0;
+  if (!f.seek(sizeof(h) + ersterBlock * sizeof(uint32_t)) ||
+      f.read((uint8_t*)&offset, sizeof(offset)) != sizeof(offset) || !f.seek(tabelleEnde + offset)) {
+    fehler = "Cache beschädigt";
+    return false;
+  }
+
+  std::vector<int32_t> q(h.blockGroesse);
+  std::vector<uint8_t> block;
+  const float teiler = (float)h.teilerProMv;
+  for (uint32_t b = ersterBlock; b <= letzterBlock; ++b) {
+    BlockHeader bh;
+    if (f.read((uint8_t*)&bh, sizeof(bh)) != sizeof(bh)) {
+      fehler = "Cache beschädigt";
+      return false;
+    }
+    block.resize(sizeof(bh) + bh.nutzdatenBytes);
+    memcpy(block.data(), &bh, sizeof(bh));
+    const uint32_t beginn = b * h.blockGroesse;
+    size_t n = h.sampleAnzahl - beginn;
+    if (n > h.blockGroesse) n = h.blockGroesse;
+    if (f.read(block.data() + sizeof(bh), bh.nutzdatenBytes) != bh.nutzdatenBytes ||
+        dekodiereBlock(block.data(), block.size(), n, q.data()) != n) {
+      fehler = "Cache beschädigt";
+      return false;
+    }
+    for (size_t i = 0; i < n; ++i) abschnitte.nimm(beginn + i, q[i] / teiler);
+  }
+  return true;
+}
+
+bool berechneVorschau(const String& pfad, uint32_t von, uint32_t bis, uint16_t punkte,
+                      Vorschau& ergebnis, String& fehler) {
+  ergebnis = Vorschau();
+  if (punkte == 0) punkte = VORSCHAU_STANDARD_PUNKTE;
+  if (punkte > VORSCHAU_MAX_PUNKTE) punkte = VORSCHAU_MAX_PUNKTE;
+
+  // Ohne .eegz-Fassung kein Ersatz aus dem Text: zwei Durchläufe durch große
+  // Dateien blockieren den AsyncTCP-Task
+  File f = SPIFFS.open(cachePfad(pfad), "r");
+  if (!f) {
+    fehler = "Keine .eegz-Fassung";
+    return false;
+  }
+  bool ok = vorschauAusCache(f, von, bis, punkte, ergebnis, fehler);
+  f.close();
+  return ok;
+}
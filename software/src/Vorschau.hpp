@@ -0,0 +1,30 @@
+#ifndef VORSCHAU_HPP
+#define VORSCHAU_HPP
+
+#include <Arduino.h>
+#include <vector>
+
+// Übersicht einer Signaldatei für GET /preview: der Bereich [von, bis) wird in
+// höchstens 'punkte' gleich lange Abschnitte geteilt, pro Abschnitt Minimum und
+// Maximum in mV (Spitzen bleiben sichtbar, anders als beim Ausdünnen).
+// Gelesen wird blockweise aus der .eegz-Fassung (über die Offset-Tabelle nur die
+// betroffenen Blöcke); der Text selbst wird nicht geparst. Der Speicherbedarf
+// hängt nur von 'punkte' ab, nicht von der Dateigröße.
+
+#define VORSCHAU_STANDARD_PUNKTE  500
+#define VORSCHAU_MAX_PUNKTE       4096
+
+struct Vorschau {
+  uint32_t sampleAnzahl = 0;    // gesamte Datei
+  uint32_t von = 0;             // tatsächlich ausgewerteter Bereich
+  uint32_t bis = 0;
+  std::vector<float> minMv;     // ein Eintrag pro Abschnitt
+  std::vector<float> maxMv;
+};
+
+// bis = 0: bis zum Dateiende. false mit Fehlertext, wenn die .eegz-Fassung
+// fehlt oder beschädigt ist
+bool berechneVorschau(const String& pfad, uint32_t von, uint32_t bis, uint16_t punkte,
+                      Vorschau& ergebnis, String& fehler);
+
+#endif // VORSCHAU_HPP
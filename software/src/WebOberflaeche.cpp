@@ -0,0 +1,32 @@
+#include "WebOberflaeche.hpp"
+#include "WebOberflaecheDaten.h"
+
+#define CACHE_DAUERHAFT  "public, max-age=31536000, immutable"
+#define CACHE_PRUEFEN    "no-cache"
+
+static void sendeWebDatei(AsyncWebServerRequest* request, const WebDatei& d) {
+  const char* cache = request->hasParam("v") ? CACHE_DAUERHAFT : CACHE_PRUEFEN;
+  if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == d.etag) {
+    AsyncWebServerResponse* antwort = request->beginResponse(304);
+    antwort->addHeader("ETag", d.etag);
+    antwort->addHeader("Cache-Control", cache);
+    request->send(antwort);
+    return;
+  }
+
+  // Sendet stückweise aus dem Flash, ohne Kopie im RAM
+  AsyncWebServerResponse* antwort = request->beginResponse_P(200, d.mime, d.daten, d.laenge);
+  if (d.gzip) antwort->addHeader("Content-Encoding", "gzip");
+  antwort->addHeader("ETag", d.etag);
+  antwort->addHeader("Cache-Control", cache);
+  request->send(antwort);
+}
+
+void registriereWebOberflaeche(AsyncWebServer& server) {
+  for (const WebDatei& d : webDateien) {
+    const WebDatei* datei = &d;
+    server.on(d.url, HTTP_GET, [datei](AsyncWebServerRequest *request) {
+      sendeWebDatei(request, *datei);
+    });
+  }
+}
@@ -0,0 +1,28 @@
+#ifndef WEBOBERFLAECHE_HPP
+#define WEBOBERFLAECHE_HPP
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// Auslieferung der Weboberfläche (HTML, script.js, Logo) direkt aus dem Flash.
+// tools/komprimiere_web.py bettet die Dateien aus web/ beim Build als
+// Byte-Arrays ein (src/WebOberflaecheDaten.h, HTML und Skript gzip-komprimiert);
+// die Oberfläche läuft damit auch bei leerem oder defektem SPIFFS.
+// Caching:
+//   - jede Antwort trägt ein ETag (Inhalts-Hash vom Build); If-None-Match -> 304
+//   - mit Versionsparameter (?v=..., vom Build-Schritt eingesetzt) darf der
+//     Browser ein Jahr lang cachen, sonst muss er jedes Mal nachfragen
+
+struct WebDatei {
+  const char* url;
+  const char* mime;
+  const uint8_t* daten;    // im Flash (PROGMEM)
+  size_t laenge;
+  bool gzip;
+  const char* etag;
+};
+
+// Registriert die Routen aller eingebetteten Dateien
+void registriereWebOberflaeche(AsyncWebServer& server);
+
+#endif // WEBOBERFLAECHE_HPP
@@ -0,0 +1,149 @@
+#include "Wiedergabebild.hpp"
+#include "Spannungswandlung.hpp"
+#include "Bootablauf.hpp"
+#include "Konfiguration.hpp"
+#include <SPIFFS.h>
+
+static_assert(sizeof(Q15) == sizeof(int16_t), "Q15 wird direkt als int16_t gespeichert");
+
+bool speichereWiedergabebild(const KanalTabelle& tabelle, float frequenzHz) {
+  File f = SPIFFS.open(WIEDERGABEBILD_TEMP, "w");
+  if (!f) return false;
+
+  BildHeader kopf = {WIEDERGABEBILD_MAGIC, WIEDERGABEBILD_VERSION, ANZAHL_KANAELE, frequenzHz};
+  bool ok = f.write((const uint8_t*)&kopf, sizeof(kopf)) == sizeof(kopf);
+  for (const Kanal& kanal : tabelle) {
+    if (!ok) break;
+    BildKanal k = {};
+    k.schleife = kanal.schleife;
+    k.modus = (uint8_t)kanal.skalierung.modus;
+    k.minMv = kanal.skalierung.minMv;
+    k.maxMv = kanal.skalierung.maxMv;
+    k.abtastrateHz = kanal.abtastrateHz;
+    k.versatzS = kanal.versatzS;
+    k.sampleAnzahl = kanal.samples.size();
+    k.markerAnzahl = kanal.marker.size();
+    const size_t sampleBytes = kanal.samples.size() * sizeof(Q15);
+    const size_t markerBytes = kanal.marker.size() * sizeof(Marker);
+    ok = f.write((const uint8_t*)&k, sizeof(k)) == sizeof(k) &&
+         f.write((const uint8_t*)kanal.samples.data(), sampleBytes) == sampleBytes &&
+         f.write((const uint8_t*)kanal.marker.data(), markerBytes) == markerBytes;
+  }
+  f.close();
+
+  if (!ok) {
+    Serial.println("⚠️ Wiedergabebild: Schreiben fehlgeschlagen (SPIFFS voll?)");
+    SPIFFS.remove(WIEDERGABEBILD_TEMP);
+    return false;
+  }
+  SPIFFS.remove(WIEDERGABEBILD_PFAD);
+  return SPIFFS.rename(WIEDERGABEBILD_TEMP, WIEDERGABEBILD_PFAD);
+}
+
+bool ladeWiedergabebild(KanalTabelle& tabelle, float& frequenzHz) {
+  // Vollständig geschriebene temporäre Datei, das alte Bild schon gelöscht;
+  // eine unvollständige scheitert unten an der Längenprüfung
+  if (!SPIFFS.exists(WIEDERGABEBILD_PFAD) && SPIFFS.exists(WIEDERGABEBILD_TEMP) &&
+      SPIFFS.rename(WIEDERGABEBILD_TEMP, WIEDERGABEBILD_PFAD)) {
+    Serial.println("Wiedergabebild: aus der temporären Datei übernommen");
+  }
+  File f = SPIFFS.open(WIEDERGABEBILD_PFAD, "r");
+  if (!f) return false;
+
+  BildHeader kopf;
+  if (f.read((uint8_t*)&kopf, sizeof(kopf)) != sizeof(kopf) || kopf.magic != WIEDERGABEBILD_MAGIC ||
+      kopf.version != WIEDERGABEBILD_VERSION || kopf.kanalAnzahl != ANZAHL_KANAELE) {
+    // z. B. nach Änderung von DAC_ANZAHL: Bild passt nicht mehr
+    Serial.println("⚠️ Wiedergabebild: unbekanntes Format, wird ignoriert");
+    f.close();
+    return false;
+  }
+
+  bool ok = true;
+  for (Kanal& kanal : tabelle) {
+    kanal = Kanal();
+    BildKanal k;
+    if (f.read((uint8_t*)&k, sizeof(k)) != sizeof(k)) {
+      ok = false;
+      break;
+    }
+    // Längen gegen den Dateirest prüfen, bevor Speicher angefordert wird
+    const size_t sampleBytes = (size_t)k.sampleAnzahl * sizeof(Q15);
+    const size_t markerBytes = (size_t)k.markerAnzahl * sizeof(Marker);
+    if (sampleBytes + markerBytes > f.available()) {
+      ok = false;
+      break;
+    }
+    kanal.schleife = k.schleife != 0;
+    kanal.skalierung = berechneSkalierung((BereichsModus)k.modus, k.minMv, k.maxMv);
+    kanal.abtastrateHz = k.abtastrateHz;
+    kanal.versatzS = k.versatzS;
+    kanal.samples.resize(k.sampleAnzahl);
+    kanal.marker.resize(k.markerAnzahl);
+    ok = f.read((uint8_t*)kanal.samples.data(), sampleBytes) == sampleBytes &&
+         f.read((uint8_t*)kanal.marker.data(), markerBytes) == markerBytes;
+    if (!ok) break;
+  }
+  f.close();
+
+  if (!ok) {
+    Serial.println("⚠️ Wiedergabebild beschädigt");
+    for (Kanal& kanal : tabelle) kanal = Kanal();
+    return false;
+  }
+  frequenzHz = kopf.frequenzHz;
+  return true;
+}
+
+void loescheWiedergabebild() {
+  SPIFFS.remove(WIEDERGABEBILD_PFAD);
+  SPIFFS.remove(WIEDERGABEBILD_TEMP);
+}
+
+size_t groesseWiedergabebild() {
+  File f = SPIFFS.open(WIEDERGABEBILD_PFAD, "r");
+  if (!f) return 0;
+  size_t groesse = f.size();
+  f.close();
+  return groesse;
+}
+
+bool autostartAktiv() {
+  return konfiguration().autostart;
+}
+
+void setzeAutostart(bool aktiv) {
+  Konfiguration k = konfiguration();
+  k.autostart = aktiv;
+  String fehler;
+  aendereKonfiguration(k, fehler);
+}
+
+void fuehreAutostartAus() {
+  if (!autostartAktiv()) return;
+
+  int phase = beginneBootPhase("Autostart laden");
+  float frequenzHz = ausgabeFrequenzHz;
+  bool geladen = false;
+  {
+    // Ein Trigger darf nicht auf die halb geladene Tabelle starten
+    KanalTabellenSperre sperre;
+    geladen = sperre.gesperrt && ladeWiedergabebild(kanalTabelle, frequenzHz);
+  }
+  beendeBootPhase(phase);
+  if (!geladen) {
+    Serial.println("⚠️ Autostart: kein gültiges Wiedergabebild");
+    return;
+  }
+  if (frequenzHz >= 1.0f && frequenzHz <= 1000.0f) setzeAusgabeFrequenz(frequenzHz);
+
+  warteAufBoot(BOOT_WIEDERGABE_BEREIT, portMAX_DELAY);
+  if (!starteWiedergabe()) return;
+  Serial.println("▶️ Autostart: Wiedergabe des letzten Programms");
+
+  // Messung: Anwendungsstart bis zur ersten DAC-Übernahme
+  for (int i = 0; i < 1000 && bootErsteAusgabeUs() < 0; ++i) vTaskDelay(pdMS_TO_TICKS(1));
+  if (bootErsteAusgabeUs() >= 0) {
+    Serial.printf("⏱️ Start bis erstes Sample: %lld µs\n", (long long)bootErsteAusgabeUs());
+  }
+}
@@ -0,0 +1,55 @@
+#ifndef WIEDERGABEBILD_HPP
+#define WIEDERGABEBILD_HPP
+
+#include <Arduino.h>
+#include "Global_Var.hpp"
+
+// Fertig umgerechnete Kanaltabelle im SPIFFS (WIEDERGABEBILD_PFAD), damit die
+// zuletzt verarbeiteten Kanäle nach dem Einschalten ohne Parsen bereitstehen.
+//
+// Aufbau der Datei (Little Endian):
+//   BildHeader
+//   pro Kanal: BildKanal, Q15-Samples (int16_t), Marker
+// Die Skalierung wird beim Laden aus Modus/Minimum/Maximum neu berechnet.
+
+#define WIEDERGABEBILD_PFAD     "/wiedergabe.img"
+#define WIEDERGABEBILD_TEMP     "/wiedergabe.tmp"
+#define WIEDERGABEBILD_MAGIC    0x42474545UL  // "EEGB"
+#define WIEDERGABEBILD_VERSION  4
+
+struct __attribute__((packed)) BildHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t kanalAnzahl;
+  float frequenzHz;          // Ausgabefrequenz bei der Verarbeitung
+};
+
+struct __attribute__((packed)) BildKanal {
+  uint8_t schleife;
+  uint8_t modus;             // BereichsModus
+  uint16_t reserviert;
+  float minMv;
+  float maxMv;
+  float abtastrateHz;        // 0 = Ausgabefrequenz
+  float versatzS;
+  uint32_t sampleAnzahl;
+  uint32_t markerAnzahl;
+};
+
+// Schreibt erst in eine temporäre Datei und benennt sie dann um. SPIFFS
+// benennt nicht über eine vorhandene Datei um; fehlt das Bild nach einem
+// Abbruch zwischen Löschen und Umbenennen, übernimmt das Laden die
+// temporäre Datei.
+bool speichereWiedergabebild(const KanalTabelle& tabelle, float frequenzHz);
+bool ladeWiedergabebild(KanalTabelle& tabelle, float& frequenzHz);
+void loescheWiedergabebild();
+size_t groesseWiedergabebild();    // 0 = keins vorhanden
+
+// Autostart: beim Booten das Bild laden und sofort abspielen (Konfiguration.hpp)
+bool autostartAktiv();
+void setzeAutostart(bool aktiv);
+
+// Aus dem Start-Task nach dem Einbinden des SPIFFS; wartet selbst auf den Abspiel-Task
+void fuehreAutostartAus();
+
+#endif // WIEDERGABEBILD_HPP
@@ -0,0 +1,65 @@
+#include "Zahlenleser.hpp"
+#include <stdlib.h>
+
+static inline bool istZiffer(char c) {
+  return c >= '0' && c <= '9';
+}
+
+void Zahlenleser::zuruecksetzen() {
+  zustand = Zustand::NICHTS;
+  laenge = 0;
+  bytes = 0;
+}
+
+void Zahlenleser::merke(char c) {
+  if (laenge < ZAHLENLESER_MAX_ZEICHEN) puffer[laenge++] = c;
+}
+
+void Zahlenleser::gibAus(std::vector<float>& werte) {
+  // "12." ohne Nachkommaziffer: nur "12" zählt (wie beim regulären Ausdruck)
+  if (zustand == Zustand::PUNKT && laenge > 0) laenge--;
+  puffer[laenge] = '\0';
+  werte.push_back((float)strtod(puffer, nullptr));
+  laenge = 0;
+  zustand = Zustand::NICHTS;
+}
+
+void Zahlenleser::verarbeite(const uint8_t* daten, size_t anzahl, std::vector<float>& werte) {
+  bytes += anzahl;
+  for (size_t i = 0; i < anzahl; ++i) {
+    const char c = (char)daten[i];
+    switch (zustand) {
+      case Zustand::GANZ:
+        if (istZiffer(c)) { merke(c); continue; }
+        if (c == '.') { merke(c); zustand = Zustand::PUNKT; continue; }
+        gibAus(werte);
+        break;
+      case Zustand::PUNKT:
+      case Zustand::BRUCH:
+        if (istZiffer(c)) { merke(c); zustand = Zustand::BRUCH; continue; }
+        gibAus(werte);
+        break;
+      case Zustand::MINUS:
+        if (istZiffer(c)) { merke(c); zustand = Zustand::GANZ; continue; }
+        laenge = 0;
+        zustand = Zustand::NICHTS;
+        break;
+      default:
+        break;
+    }
+    // Zeichen nach einer abgeschlossenen Zahl kann die nächste beginnen
+    if (c == '-') {
+      merke(c);
+      zustand = Zustand::MINUS;
+    } else if (istZiffer(c)) {
+      merke(c);
+      zustand = Zustand::GANZ;
+    }
+  }
+}
+
+void Zahlenleser::beende(std::vector<float>& werte) {
+  if (zustand == Zustand::GANZ || zustand == Zustand::PUNKT || zustand == Zustand::BRUCH) gibAus(werte);
+  laenge = 0;
+  zustand = Zustand::NICHTS;
+}
@@ -0,0 +1,38 @@
+#ifndef ZAHLENLESER_HPP
+#define ZAHLENLESER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Schrittweiser Zahlenleser für Signaldateien: nimmt den Text in beliebig
+// geteilten Stücken entgegen (z. B. direkt aus dem Upload-Callback) und hängt
+// jede vollständige Zahl an 'werte' an. Erkennt Zahlen nach dem Muster
+// "-?[0-9]+(\.[0-9]+)?" (Wert wie atof()); eine über die Stückgrenze
+// geteilte Zahl wird im Zustand zwischengehalten. Kein regulärer Ausdruck,
+// keine Kopie des Textes.
+
+#define ZAHLENLESER_MAX_ZEICHEN  48   // längere Ziffernfolgen werden abgeschnitten
+
+class Zahlenleser {
+public:
+  void verarbeite(const uint8_t* daten, size_t laenge, std::vector<float>& werte);
+  // Nach dem letzten Stück: schließt eine noch offene Zahl ab
+  void beende(std::vector<float>& werte);
+  void zuruecksetzen();
+
+  size_t gelesenBytes() const { return bytes; }
+
+private:
+  enum class Zustand : uint8_t { NICHTS, MINUS, GANZ, PUNKT, BRUCH };
+
+  void merke(char c);
+  void gibAus(std::vector<float>& werte);
+
+  Zustand zustand = Zustand::NICHTS;
+  char puffer[ZAHLENLESER_MAX_ZEICHEN + 1];
+  uint8_t laenge = 0;
+  size_t bytes = 0;
+};
+
+#endif // ZAHLENLESER_HPP
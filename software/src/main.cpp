@@ -8,63 +8,107 @@
 #include "Server.hpp"
 #include "PinMapping.hpp"
 #include "Spannungswandlung.hpp"
+#include "Kalibrierung.hpp"
+#include "Synchronisation.hpp"
+#include "Trigger.hpp"
+#include "Bootablauf.hpp"
+#include "Wiedergabebild.hpp"
+#include "Konfiguration.hpp"
+#include "TaskTopologie.hpp"
 
 // Globale Serverinstanz
 AsyncWebServer server(80);
 
-std::map<String, std::vector<float>> kanalDaten;
-std::vector<FileData> uploadedFiles;
-std::map<AsyncWebServerRequest*, ActiveUpload> activeUploads;
+KanalTabelle kanalTabelle;
+std::array<ActiveUpload, UPLOAD_PLAETZE> activeUploads;
 
-extern void ladeFrequenzAusDatei();
+// Core 0: Dateisystem einbinden (kann beim ersten Start formatieren) und Einstellungen laden
+static void speicherTask(void* parameter) {
+  int phase = beginneBootPhase("SPIFFS");
+  if (!SPIFFS.begin(true)) {
+    // Weboberfläche liegt im Flash und bleibt erreichbar, nur ohne Dateien
+    Serial.println("❌ SPIFFS Fehler, weiter ohne Dateisystem");
+  }
+  beendeBootPhase(phase);
 
-void setup() {
-  Serial.begin(115200);
-  delay(1000);
+  // Frühere Fassungen hielten die Frequenz in /freq.cfg
+  uebernehmeFrequenzdatei();
+  setzeAusgabeFrequenz(konfiguration().frequenzHz);
 
-  Serial.println("Pin Mapping initialisieren...");
-  initPinModes();
-  delay(100);
-  Serial.println("DACs initialisieren...");
-  digitalWrite(RST, LOW); // Reset des DACs
-  delayMicroseconds(1);          // Setup-Zeit (tWS ≥ 0 ns)
-  digitalWrite(RST, HIGH); // Reset des DACs beenden
-  delay(100); // Warten, bis der Reset abgeschlossen ist
-  Serial.println("Starte Netzwerkstack...");
+  meldeBootBereit(BOOT_SPEICHER_BEREIT);
+
+  // Letztes Programm aus dem Wiedergabebild, ohne Parsen
+  fuehreAutostartAus();
+  vTaskDelete(nullptr);
+}
+
+// Core 0: SoftAP und Webserver
+static void netzTask(void* parameter) {
+  int phase = beginneBootPhase("WLAN");
   esp_netif_init();
   esp_event_loop_create_default();
-  Serial.println("Initialisiere WiFi...");
   WiFi.mode(WIFI_AP);
   delay(250);  // wichtig!
   bool ok = WiFi.softAP("EEGsimulator", "EEGsimulator2525");
-  delay(250);
+  beendeBootPhase(phase);
   if (!ok) {
+    // Wiedergabe (Trigger, Autostart) läuft ohne Netz weiter
     Serial.println("❌ SoftAP-Start fehlgeschlagen!");
-    while (true);
+    vTaskDelete(nullptr);
   }
   Serial.println("✅ SoftAP IP: " + WiFi.softAPIP().toString());
- Serial.println("WiFi Passwort: EEGsimulator2525");
+  Serial.println("WiFi Passwort: EEGsimulator2525");
 
-  Serial.println("Initialisiere SPIFFS...");
-  if (!SPIFFS.begin(true)) {
-    Serial.println("❌ SPIFFS Fehler");
-    while (true);
-  }
+  phase = beginneBootPhase("Webserver");
+  setupWebServer();
+  server.begin();
+  beendeBootPhase(phase);
+  Serial.println("✅ Webserver aktiv.");
+  meldeBootBereit(BOOT_NETZ_BEREIT);
 
-  delay(100);
+  warteAufBoot(BOOT_WIEDERGABE_BEREIT | BOOT_SPEICHER_BEREIT, pdMS_TO_TICKS(10000));
+  gibBootZeitlinieAus();
+  vTaskDelete(nullptr);
+}
 
-  Serial.println("Lade Frequenz aus Datei...");
-  ladeFrequenzAusDatei();
+void setup() {
+  Serial.begin(115200);
+  initBootablauf();
 
-  delay(100);
+  // DAC zuerst: definierter Ausgang, bevor irgendetwas anderes wartet
+  int phase = beginneBootPhase("DAC");
+  initPinModes();
+  digitalWrite(RST, LOW); // Reset des DACs
+  delayMicroseconds(1);          // Setup-Zeit (tWS ≥ 0 ns)
+  digitalWrite(RST, HIGH); // Reset des DACs beenden
+  delay(1); // Warten, bis der Reset abgeschlossen ist (weit über der Reset-Zeit)
+  initDacRouting();
+  beendeBootPhase(phase);
 
+  // Konfiguration vor den Start-Tasks, die sie bereits lesen
+  phase = beginneBootPhase("Konfiguration");
+  ladeKonfiguration();
+  setzeAusgabeFrequenz(konfiguration().frequenzHz);
+  beendeBootPhase(phase);
 
-  Serial.println("Starte Webserver...");
-  setupWebServer();
-  server.begin();
-  Serial.println("✅ Webserver aktiv.");
+  // Dateisystem und WLAN parallel auf Core 0
+  xTaskCreatePinnedToCore(speicherTask, "BootSpeicher", BOOT_TASK_STACK, nullptr,
+                          BOOT_TASK_PRIO, nullptr, BOOT_TASK_CORE);
+  xTaskCreatePinnedToCore(netzTask, "BootNetz", BOOT_TASK_STACK, nullptr,
+                          BOOT_TASK_PRIO, nullptr, BOOT_TASK_CORE);
+
+  // Wiedergabe: alles aus dem NVS, unabhängig von SPIFFS und WLAN
+  phase = beginneBootPhase("Wiedergabe");
+  ladeKalibrierung();
+  gebeRuhepegelAus();
+  initSynchronisation();
+  initAbspielTask();
+  initTrigger();
+  beendeBootPhase(phase);
+  meldeBootBereit(BOOT_WIEDERGABE_BEREIT);
 }
 
 void loop() {
+  bearbeiteKonfiguration(); // verzögertes Speichern ins NVS
   delay(10); // Leerlauf mit RTOS-Kooperation
 }
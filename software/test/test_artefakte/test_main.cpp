@@ -0,0 +1,72 @@
+// Host-Tests für die Artefakt-Überlagerung (Artefakte.hpp): Netzbrummen im
+// Ausgabetakt, Ereignisse im Quelltakt
+#include <unity.h>
+#include <vector>
+#include "Artefakte.hpp"
+
+#define RUHE  2048
+
+static KanalArtefakte brummen(float frequenzHz, float amplitudeMv) {
+  KanalArtefakte a;
+  a.typ[NETZBRUMMEN].aktiv = true;
+  a.typ[NETZBRUMMEN].frequenzHz = frequenzHz;
+  a.typ[NETZBRUMMEN].amplitudeMv = amplitudeMv;
+  return a;
+}
+
+// Vorzeichenwechsel um die Ruhelage = doppelte Periodenzahl
+static uint32_t nulldurchgaenge(const std::vector<uint16_t>& codes) {
+  uint32_t anzahl = 0;
+  for (size_t i = 1; i < codes.size(); ++i) anzahl += (codes[i - 1] < RUHE) != (codes[i] < RUHE);
+  return anzahl;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// 50 Hz bei 100 Hz Quelltakt: mit 8-facher Überabtastung eine volle Sinusform
+void test_brummen_im_ausgabetakt() {
+  KanalArtefaktZustand zustand;
+  bereiteArtefakteVor(brummen(50.0f, 10.0f), 10.0f, 100.0f, 800.0f, 1, zustand);
+  std::vector<uint16_t> codes(800, RUHE);
+  mischeBrummen(zustand, codes.data(), codes.size());
+  TEST_ASSERT_UINT32_WITHIN(2, 100, nulldurchgaenge(codes));
+  uint16_t maximum = 0;
+  for (uint16_t c : codes) maximum = c > maximum ? c : maximum;
+  TEST_ASSERT_UINT32_WITHIN(2, RUHE + 100, maximum);
+}
+
+// Ohne Überabtastung liegt 50 Hz auf der Nyquist-Frequenz: bleibt aus statt stumm
+void test_brummen_nicht_darstellbar() {
+  TEST_ASSERT_FALSE(brummenDarstellbar(50.0f, 100.0f));
+  TEST_ASSERT_TRUE(brummenDarstellbar(50.0f, 800.0f));
+  KanalArtefaktZustand zustand;
+  bereiteArtefakteVor(brummen(50.0f, 10.0f), 10.0f, 100.0f, 100.0f, 1, zustand);
+  TEST_ASSERT_FALSE(zustand.aktiv);
+}
+
+// Ereignisse zählen Quellsamples; das Brummen beeinflussen sie nicht
+void test_ereignis_im_quelltakt() {
+  KanalArtefakte a = brummen(50.0f, 10.0f);
+  a.typ[LIDSCHLAG].aktiv = true;
+  a.typ[LIDSCHLAG].amplitudeMv = 20.0f;
+  a.typ[LIDSCHLAG].intervallS = 1.0f;
+  a.typ[LIDSCHLAG].dauerS = 0.5f;
+  KanalArtefaktZustand zustand;
+  bereiteArtefakteVor(a, 10.0f, 100.0f, 800.0f, 1, zustand);
+  std::vector<uint16_t> quelle(200, RUHE);
+  mischeArtefakte(zustand, quelle.data(), quelle.size());
+  // Erstes Ereignis nach 1 s = 100 Quellsamples
+  for (size_t i = 0; i < 99; ++i) TEST_ASSERT_EQUAL_UINT16(RUHE, quelle[i]);
+  uint16_t maximum = 0;
+  for (uint16_t c : quelle) maximum = c > maximum ? c : maximum;
+  TEST_ASSERT_UINT32_WITHIN(3, RUHE + 200, maximum);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_brummen_im_ausgabetakt);
+  RUN_TEST(test_brummen_nicht_darstellbar);
+  RUN_TEST(test_ereignis_im_quelltakt);
+  return UNITY_END();
+}
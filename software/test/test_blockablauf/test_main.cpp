@@ -0,0 +1,161 @@
+// Host-Test für den Wiedergabeablauf (Blockablauf.hpp) mit simuliertem DAC
+// und simulierter Uhr: Umrechnen und Segmentwechsel kosten Zeit, jeder Frame
+// muss trotzdem genau zu seiner Frist und mit dem richtigen Sample erscheinen
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+#include "Blockablauf.hpp"
+
+#define BLOCK           32
+#define PERIODE_US      1000    // pro Ausgabeframe
+#define FUELLEN_US      300     // Umrechnung eines Blocks
+#define SEGMENT_US      450     // Holen des nächsten Segments
+#define FRAME_US        5       // Schreiben aller Kanäle
+
+struct DacFrame {
+  int64_t zeitUs;
+  uint32_t wert;
+};
+
+struct Simulation {
+  std::vector<size_t> segmente;      // Längen in Quellsamples
+  size_t segment = 0;
+  size_t basis = 0;                  // erstes Sample des laufenden Segments
+  uint8_t faktor = 1;
+  int64_t jetztUs = 0;
+  int64_t fristUs = 0;
+  uint32_t puffer[BLOCK * 4] = {};   // "Codes" = Samplenummer * faktor + Unterframe
+  size_t pufferBasis = 0;            // Sample, für das der Puffer gefüllt ist
+  size_t pufferAnzahl = 0;
+  size_t weiterNachSample = SIZE_MAX;
+  size_t abbruchNachFrames = SIZE_MAX;
+  std::vector<DacFrame> dac;
+  int64_t maxVerspaetungUs = 0;
+
+  void fuelle(size_t i, size_t anzahl) {
+    jetztUs += FUELLEN_US;
+    pufferBasis = basis + i;
+    pufferAnzahl = anzahl;
+    for (size_t j = 0; j < anzahl * faktor; ++j) puffer[j] = (uint32_t)((basis + i) * faktor + j);
+  }
+  bool abbrechen() const { return dac.size() >= abbruchNachFrames; }
+  bool frame(size_t i, size_t pos) {
+    // Der Puffer muss zum Block passen, bevor der Frame geschrieben wird
+    TEST_ASSERT_EQUAL_UINT32(basis + i, pufferBasis);
+    TEST_ASSERT_LESS_THAN(pufferAnzahl * faktor, pos);
+    const int64_t verspaetung = jetztUs - fristUs;
+    if (verspaetung > maxVerspaetungUs) maxVerspaetungUs = verspaetung;
+    dac.push_back({ jetztUs, puffer[pos] });
+    jetztUs += FRAME_US;
+    return true;
+  }
+  bool segmentEnde() {
+    const size_t gespielt = dac.size() / faktor;
+    return dac.size() % faktor == 0 && gespielt == weiterNachSample + 1;
+  }
+  bool naechstesSegment(size_t& laenge) {
+    basis += laenge;
+    if (++segment >= segmente.size()) return false;
+    jetztUs += SEGMENT_US;
+    laenge = segmente[segment];
+    return true;
+  }
+  void warte(size_t) {
+    fristUs += PERIODE_US;
+    if (jetztUs < fristUs) jetztUs = fristUs;
+  }
+};
+
+static void spiele(Simulation& sim) {
+  sim.fuelle(0, sim.segmente[0] < BLOCK ? sim.segmente[0] : BLOCK);
+  sim.jetztUs = sim.fristUs = 0;   // Start nach dem Vorfüllen
+  spieleBloecke(sim, sim.segmente[0], BLOCK, sim.faktor);
+}
+
+static void pruefePuenktlich(uint8_t faktor) {
+  Simulation sim;
+  sim.faktor = faktor;
+  sim.segmente = { 70, 33, 1, 100 };
+  spiele(sim);
+  const size_t gesamt = (70 + 33 + 1 + 100) * faktor;
+  TEST_ASSERT_EQUAL_UINT32(gesamt, sim.dac.size());
+  for (size_t n = 0; n < sim.dac.size(); ++n) {
+    TEST_ASSERT_EQUAL_UINT32(n, sim.dac[n].wert);
+    TEST_ASSERT_EQUAL_INT64((int64_t)n * PERIODE_US, sim.dac[n].zeitUs);
+  }
+  TEST_ASSERT_EQUAL_INT64(0, sim.maxVerspaetungUs);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Block- und Segmentgrenzen ohne Verspätung, Samples lückenlos
+void test_puenktlich_ohne_ueberabtastung() { pruefePuenktlich(1); }
+void test_puenktlich_mit_ueberabtastung() { pruefePuenktlich(4); }
+
+// Trigger "weiter": Segment endet nach dem laufenden Sample, das nächste
+// beginnt im folgenden Frame pünktlich
+void test_weiter_wechselt_puenktlich() {
+  Simulation sim;
+  sim.segmente = { 200, 10 };
+  sim.weiterNachSample = 40;
+  spiele(sim);
+  TEST_ASSERT_EQUAL_UINT32(41 + 10, sim.dac.size());
+  TEST_ASSERT_EQUAL_UINT32(40, sim.dac[40].wert);
+  TEST_ASSERT_EQUAL_UINT32(41, sim.dac[41].wert);   // erstes Sample von Segment 2 (Basis 41)
+  TEST_ASSERT_EQUAL_INT64(41 * PERIODE_US, sim.dac[41].zeitUs);
+  TEST_ASSERT_EQUAL_INT64(0, sim.maxVerspaetungUs);
+}
+
+// Abbruch wirkt an der nächsten Blockgrenze
+void test_abbruch_an_blockgrenze() {
+  Simulation sim;
+  sim.segmente = { 500 };
+  sim.abbruchNachFrames = 40;
+  spiele(sim);
+  TEST_ASSERT_EQUAL_UINT32(2 * BLOCK, sim.dac.size());
+}
+
+// Früherer Ablauf zum Vergleich: Umrechnung bzw. Segmentwechsel erst nach
+// dem Aufwachen zur Frist des ersten Frames
+static void spieleBloeckeAlt(Simulation& sim, size_t laenge) {
+  bool erstes = true;
+  do {
+    for (size_t i = 0; i < laenge; i += BLOCK) {
+      const size_t anzahl = laenge - i < BLOCK ? laenge - i : BLOCK;
+      if (!erstes) sim.fuelle(i, anzahl);
+      erstes = false;
+      for (size_t pos = 0; pos < anzahl * sim.faktor; ++pos) {
+        sim.frame(i, pos);
+        sim.warte(pos);
+      }
+    }
+  } while (sim.naechstesSegment(laenge));
+}
+
+void test_vergleich_alter_ablauf() {
+  Simulation alt;
+  alt.segmente = { 64, 64 };
+  alt.fuelle(0, BLOCK);
+  alt.jetztUs = alt.fristUs = 0;
+  spieleBloeckeAlt(alt, alt.segmente[0]);
+  Simulation neu;
+  neu.segmente = { 64, 64 };
+  spiele(neu);
+  char text[120];
+  snprintf(text, sizeof(text), "Verspätung erster Frame eines Blocks/Segments: vorher %lld µs, jetzt %lld µs",
+           (long long)alt.maxVerspaetungUs, (long long)neu.maxVerspaetungUs);
+  TEST_MESSAGE(text);
+  TEST_ASSERT_EQUAL_INT64(SEGMENT_US + FUELLEN_US, alt.maxVerspaetungUs);
+  TEST_ASSERT_EQUAL_INT64(0, neu.maxVerspaetungUs);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_puenktlich_ohne_ueberabtastung);
+  RUN_TEST(test_puenktlich_mit_ueberabtastung);
+  RUN_TEST(test_weiter_wechselt_puenktlich);
+  RUN_TEST(test_abbruch_an_blockgrenze);
+  RUN_TEST(test_vergleich_alter_ablauf);
+  return UNITY_END();
+}
@@ -0,0 +1,127 @@
+#include <unity.h>
+#include <stdio.h>
+#include "DacBus.hpp"
+
+// Routing-Simulation für 16 und 32 Kanäle: simulierte GPIO-Bänke, daran
+// DAC8412-Modelle (Eingangsregister bei steigender CS-Flanke, Ausgänge bei
+// fallender LDAC-Flanke). Die erreichbare Framerate wird aus den gezählten
+// Registerzugriffen und Pulsen geschätzt.
+
+// Annahme für die Schätzung: ein GPIO-Registerzugriff über den APB kostet
+// auf dem ESP32-S3 bei 240 MHz rund 50 ns; Pulsdauer wie in DacRouting.cpp
+#define REGISTERZUGRIFF_NS  50
+#define DAC_PULS_NS         200
+
+static const uint8_t datenPins[12] = { DB0, DB1, DB2, DB3, DB4, DB5, DB6, DB7, DB8, DB9, DB10, DB11 };
+// Freie GPIOs beider Bänke für die Chip-Select-Leitungen
+static const uint8_t csPins[8] = { 3, 4, 5, 6, 45, 46, 47, 48 };
+
+template <uint8_t BAUSTEINE>
+struct Simulation {
+  uint64_t pins = ~0ULL;               // Ruhepegel: alle Leitungen HIGH
+  uint16_t eingang[BAUSTEINE][KANAELE_PRO_DAC] = {};
+  uint16_t ausgang[BAUSTEINE][KANAELE_PRO_DAC] = {};
+  uint32_t zugriffe = 0;
+  uint32_t pulse = 0;
+
+  static bool pegel(uint64_t p, uint8_t gpio) { return (p >> gpio) & 1; }
+
+  void flanken(uint64_t vorher) {
+    for (uint8_t d = 0; d < BAUSTEINE; ++d) {
+      if (!pegel(vorher, csPins[d]) && pegel(pins, csPins[d]) && !pegel(pins, R_W)) {
+        uint8_t adr = pegel(pins, ADD0) | (pegel(pins, ADD1) << 1);
+        uint16_t daten = 0;
+        for (uint8_t bit = 0; bit < 12; ++bit) daten |= pegel(pins, datenPins[bit]) << bit;
+        eingang[d][adr] = daten;
+      }
+    }
+    if (pegel(vorher, Load_Data) && !pegel(pins, Load_Data)) {
+      for (uint8_t d = 0; d < BAUSTEINE; ++d)
+        for (uint8_t a = 0; a < KANAELE_PRO_DAC; ++a) ausgang[d][a] = eingang[d][a];
+    }
+  }
+
+  // Reihenfolge wie in DacRouting.cpp: W1TC beider Bänke, dann W1TS
+  void schreibe(const BusMaske& m) {
+    uint64_t vorher = pins;
+    pins &= ~((uint64_t)m.loeschen0 | ((uint64_t)m.loeschen1 << 32));
+    flanken(vorher);
+    vorher = pins;
+    pins |= (uint64_t)m.setzen0 | ((uint64_t)m.setzen1 << 32);
+    flanken(vorher);
+    zugriffe += 4;
+  }
+  void schreibeInvertiert(const BusMaske& m) {
+    uint64_t vorher = pins;
+    pins |= (uint64_t)m.loeschen0 | ((uint64_t)m.loeschen1 << 32);
+    flanken(vorher);
+    zugriffe += 2;
+  }
+  void puls() { pulse++; }
+};
+
+template <uint8_t BAUSTEINE>
+static void pruefeRouting() {
+  DacBus<BAUSTEINE> bus;
+  bus.baue(datenPins, ADD0, ADD1, csPins, Load_Data);
+  Simulation<BAUSTEINE> sim;
+  sim.pins &= ~(1ULL << R_W);
+  const uint16_t kanaele = BAUSTEINE * KANAELE_PRO_DAC;
+
+  // Jeder Kanal erhält einen eigenen Wert; vor LDAC bleiben die Ausgänge stehen
+  for (uint16_t k = 0; k < kanaele; ++k) bus.schreibe(sim, k, (uint16_t)(k * 127 + 5) & 0x0FFF);
+  for (uint16_t k = 0; k < kanaele; ++k) {
+    TEST_ASSERT_EQUAL_UINT16((k * 127 + 5) & 0x0FFF, sim.eingang[k / KANAELE_PRO_DAC][k % KANAELE_PRO_DAC]);
+    TEST_ASSERT_EQUAL_UINT16(0, sim.ausgang[k / KANAELE_PRO_DAC][k % KANAELE_PRO_DAC]);
+  }
+  bus.uebernehmen(sim);
+  for (uint16_t k = 0; k < kanaele; ++k)
+    TEST_ASSERT_EQUAL_UINT16((k * 127 + 5) & 0x0FFF, sim.ausgang[k / KANAELE_PRO_DAC][k % KANAELE_PRO_DAC]);
+
+  // Alle Codes auf dem letzten Kanal, ohne die übrigen zu berühren
+  const uint16_t letzter = kanaele - 1;
+  for (uint16_t code = 0; code < 4096; ++code) {
+    bus.schreibe(sim, letzter, code);
+    TEST_ASSERT_EQUAL_UINT16(code, sim.eingang[letzter / KANAELE_PRO_DAC][letzter % KANAELE_PRO_DAC]);
+  }
+  TEST_ASSERT_EQUAL_UINT16(5, sim.eingang[0][0]);
+}
+
+template <uint8_t BAUSTEINE>
+static void schaetzeFramerate() {
+  DacBus<BAUSTEINE> bus;
+  bus.baue(datenPins, ADD0, ADD1, csPins, Load_Data);
+  Simulation<BAUSTEINE> sim;
+  const uint16_t kanaele = BAUSTEINE * KANAELE_PRO_DAC;
+  for (uint16_t k = 0; k < kanaele; ++k) bus.schreibe(sim, k, 2048);
+  bus.uebernehmen(sim);
+
+  const uint32_t frameNs = sim.zugriffe * REGISTERZUGRIFF_NS + sim.pulse * DAC_PULS_NS;
+  const float frameRate = 1e9f / frameNs;
+  char text[160];
+  snprintf(text, sizeof(text), "%u Kanäle: %u Registerzugriffe, %u Pulse pro Frame → ~%.1f µs, ~%.1f kHz",
+           kanaele, sim.zugriffe, sim.pulse, frameNs / 1000.0f, frameRate / 1000.0f);
+  TEST_MESSAGE(text);
+  // Kosten wachsen linear mit der Kanalzahl: 10 Zugriffe und ein Puls pro Kanal
+  TEST_ASSERT_EQUAL_UINT32(kanaele * 10 + 6, sim.zugriffe);
+  TEST_ASSERT_EQUAL_UINT32(kanaele + 1, sim.pulse);
+  // Auch 32 Kanäle bleiben weit über der höchsten Ausgabefrequenz samt Filterfaktor
+  TEST_ASSERT_GREATER_THAN(10000, (int)frameRate);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_routing_16_kanaele() { pruefeRouting<4>(); }
+void test_routing_32_kanaele() { pruefeRouting<8>(); }
+void test_framerate_16_kanaele() { schaetzeFramerate<4>(); }
+void test_framerate_32_kanaele() { schaetzeFramerate<8>(); }
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_routing_16_kanaele);
+  RUN_TEST(test_routing_32_kanaele);
+  RUN_TEST(test_framerate_16_kanaele);
+  RUN_TEST(test_framerate_32_kanaele);
+  return UNITY_END();
+}
@@ -0,0 +1,120 @@
+// Host-Test für die Festkomma-Bibliothek (Festkomma.hpp) und den Q15-Abspielpfad
+// (Skalierung.hpp): Fehlerschranken gegenüber der Rechnung in float/double
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include "Festkomma.hpp"
+#include "Skalierung.hpp"
+
+#define Q15_LSB  (1.0 / 32768.0)
+#define Q31_LSB  (1.0 / 2147483648.0)
+
+void setUp() {}
+void tearDown() {}
+
+static uint32_t zufall = 4711;
+static uint32_t naechsteZufallszahl() {
+  zufall = zufall * 1664525u + 1013904223u;
+  return zufall;
+}
+
+// Umwandlung aus float rundet zum nächsten Wert: höchstens 1/2 LSB im
+// darstellbaren Bereich, darüber Sättigung
+void test_q15_aus_float_rundet() {
+  double maxFehler = 0.0;
+  for (int32_t i = -320000; i < 320000; ++i) {
+    const float x = i / 320000.0f;
+    if (x > 32767.0f / 32768.0f) continue;
+    const double fehler = fabs((double)Q15::ausFloat(x).alsFloat() - x);
+    if (fehler > maxFehler) maxFehler = fehler;
+  }
+  TEST_ASSERT_TRUE(maxFehler <= 0.5 * Q15_LSB + 1e-9);
+  TEST_ASSERT_EQUAL_INT16(32767, Q15::ausFloat(1.5f).roh);
+  TEST_ASSERT_EQUAL_INT16(-32768, Q15::ausFloat(-1.5f).roh);
+  TEST_ASSERT_EQUAL_INT16(0, Q15::ausFloat(NAN).roh);
+}
+
+// Produkt gerundet: höchstens 1/2 LSB neben dem exakten Produkt, nur
+// -1 * -1 sättigt
+void test_q15_multiplikation_halbes_lsb() {
+  double maxFehler = 0.0;
+  for (int32_t a = -32768; a < 32768; a += 37) {
+    for (int32_t b = -32768; b < 32768; b += 41) {
+      const double exakt = (a * Q15_LSB) * (b * Q15_LSB);
+      const Q15 p = Q15::ausRoh((int16_t)a) * Q15::ausRoh((int16_t)b);
+      const double fehler = fabs(p.roh * Q15_LSB - exakt);
+      if (exakt < 1.0 && fehler > maxFehler) maxFehler = fehler;
+    }
+  }
+  TEST_ASSERT_TRUE(maxFehler <= 0.5 * Q15_LSB);
+  TEST_ASSERT_EQUAL_INT16(32767, (Q15::ausRoh(-32768) * Q15::ausRoh(-32768)).roh);
+}
+
+void test_q15_addition_saettigt() {
+  TEST_ASSERT_EQUAL_INT16(32767, (Q15::ausRoh(30000) + Q15::ausRoh(30000)).roh);
+  TEST_ASSERT_EQUAL_INT16(-32768, (Q15::ausRoh(-30000) + Q15::ausRoh(-30000)).roh);
+  TEST_ASSERT_EQUAL_INT16(-32768, (Q15::ausRoh(-30000) - Q15::ausRoh(30000)).roh);
+  TEST_ASSERT_EQUAL_INT16(100, (Q15::ausRoh(-200) + Q15::ausRoh(300)).roh);
+}
+
+void test_q31_multiplikation_halbes_lsb() {
+  double maxFehler = 0.0;
+  for (int n = 0; n < 200000; ++n) {
+    const int32_t a = (int32_t)naechsteZufallszahl();
+    const int32_t b = (int32_t)naechsteZufallszahl();
+    const long double exakt = ((long double)a * Q31_LSB) * ((long double)b * Q31_LSB);
+    const Q31 p = Q31::ausRoh(a) * Q31::ausRoh(b);
+    const double fehler = (double)fabsl((long double)p.roh * Q31_LSB - exakt);
+    if (fehler > maxFehler) maxFehler = fehler;
+  }
+  TEST_ASSERT_TRUE(maxFehler <= 0.5 * Q31_LSB);
+  TEST_ASSERT_EQUAL_INT32(INT32_MAX, (Q31::ausRoh(INT32_MIN) * Q31::ausRoh(INT32_MIN)).roh);
+}
+
+// Tabellen-Sinus: höchstens 2 LSB neben sin() über eine volle Umdrehung
+void test_sinus_zwei_lsb() {
+  double maxFehler = 0.0;
+  for (uint32_t i = 0; i < 65536; ++i) {
+    const uint32_t phase = i << 16 | (i * 2654435761u >> 16);
+    const double exakt = sin(phase * (2.0 * M_PI / 4294967296.0));
+    const double fehler = fabs(sinusQ15(phase).roh * Q15_LSB - exakt) / Q15_LSB;
+    if (fehler > maxFehler) maxFehler = fehler;
+  }
+  TEST_ASSERT_TRUE(maxFehler <= 2.0);
+  char text[80];
+  snprintf(text, sizeof(text), "sinusQ15: größter Fehler %.2f LSB", maxFehler);
+  TEST_MESSAGE(text);
+}
+
+// Abspielpfad: mV -> Q15 beim Laden, Q15 -> DAC-Code beim Abspielen weicht
+// höchstens 1 LSB von round((mV - minMv) * codesProMv) in float ab
+void test_abspielpfad_ein_lsb() {
+  const float bereiche[][2] = {{-150.0f, 150.0f}, {-0.5f, 0.5f}, {-3.0f, 7.0f}, {0.1f, 0.2f}};
+  uint32_t abweichend = 0;
+  uint32_t gesamt = 0;
+  for (const auto& b : bereiche) {
+    const KanalSkalierung s = berechneSkalierung(BereichsModus::BENUTZER, b[0], b[1]);
+    for (int32_t n = 0; n <= 100000; ++n) {
+      const float mv = b[0] + (b[1] - b[0]) * (n / 100000.0f);
+      const int32_t exakt = (int32_t)lroundf((mv - s.minMv) * s.codesProMv);
+      const int32_t code = codeAusQ15(normiereMv(mv, s));
+      TEST_ASSERT_INT_WITHIN(1, exakt, code);
+      if (code != exakt) abweichend++;
+      gesamt++;
+    }
+  }
+  char text[80];
+  snprintf(text, sizeof(text), "Abspielpfad: %u von %u Codes um 1 LSB abweichend", abweichend, gesamt);
+  TEST_MESSAGE(text);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_q15_aus_float_rundet);
+  RUN_TEST(test_q15_multiplikation_halbes_lsb);
+  RUN_TEST(test_q15_addition_saettigt);
+  RUN_TEST(test_q31_multiplikation_halbes_lsb);
+  RUN_TEST(test_sinus_zwei_lsb);
+  RUN_TEST(test_abspielpfad_ein_lsb);
+  return UNITY_END();
+}
@@ -0,0 +1,84 @@
+// Host-Tests für baueKalibrierLut() und kalibrierungGueltig() (Kalibrierung.hpp)
+#include <unity.h>
+#include <math.h>
+#include "Kalibrierung.hpp"
+
+static uint16_t lut[DAC_CODES];
+
+void setUp() {}
+void tearDown() {}
+
+void test_standard_ist_identitaet() {
+  baueKalibrierLut(KanalKalibrierung(), lut);
+  for (int code = 0; code < DAC_CODES; ++code) TEST_ASSERT_EQUAL_UINT16(code, lut[code]);
+}
+
+void test_gain_und_offset_gerundet() {
+  KanalKalibrierung k;
+  k.gain = 0.98f;
+  k.offset = 12.4f;
+  baueKalibrierLut(k, lut);
+  for (int code = 0; code < DAC_CODES; ++code) {
+    TEST_ASSERT_EQUAL_UINT16((uint16_t)lroundf(code * 0.98f + 12.4f), lut[code]);
+  }
+}
+
+void test_begrenzung_auf_den_codebereich() {
+  KanalKalibrierung k;
+  k.gain = 1.1f;
+  k.offset = -20.0f;
+  baueKalibrierLut(k, lut);
+  TEST_ASSERT_EQUAL_UINT16(0, lut[0]);
+  TEST_ASSERT_EQUAL_UINT16(0, lut[18]);
+  TEST_ASSERT_EQUAL_UINT16(DAC_CODES - 1, lut[DAC_CODES - 1]);
+  for (int code = 1; code < DAC_CODES; ++code) TEST_ASSERT_TRUE(lut[code] >= lut[code - 1]);
+}
+
+void test_stuetzstellen_linear_interpoliert_und_randwerte_gehalten() {
+  KanalKalibrierung k;
+  k.anzahlStuetzstellen = 3;
+  k.stuetzCode[0] = 1000; k.korrektur[0] = 4;
+  k.stuetzCode[1] = 2000; k.korrektur[1] = -6;
+  k.stuetzCode[2] = 3000; k.korrektur[2] = 10;
+  baueKalibrierLut(k, lut);
+  TEST_ASSERT_EQUAL_UINT16(0 + 4, lut[0]);          // vor der ersten Stützstelle: Randwert
+  TEST_ASSERT_EQUAL_UINT16(1000 + 4, lut[1000]);
+  TEST_ASSERT_EQUAL_UINT16(1500 - 1, lut[1500]);    // Mitte zwischen +4 und -6
+  TEST_ASSERT_EQUAL_UINT16(2000 - 6, lut[2000]);
+  TEST_ASSERT_EQUAL_UINT16(2500 + 2, lut[2500]);
+  TEST_ASSERT_EQUAL_UINT16(4000 + 10, lut[4000]);   // dahinter: Randwert
+  TEST_ASSERT_EQUAL_UINT16(3500 + 10, lut[3500]);
+}
+
+void test_gueltigkeit() {
+  KanalKalibrierung k;
+  TEST_ASSERT_TRUE(kalibrierungGueltig(k));
+  k.gain = 0.0f;
+  TEST_ASSERT_FALSE(kalibrierungGueltig(k));
+  k.gain = INFINITY;   // z. B. "gain": 1e39 aus dem JSON
+  TEST_ASSERT_FALSE(kalibrierungGueltig(k));
+  k.gain = NAN;
+  TEST_ASSERT_FALSE(kalibrierungGueltig(k));
+  k.gain = 1.0f;
+  k.offset = NAN;
+  TEST_ASSERT_FALSE(kalibrierungGueltig(k));
+  k.offset = 0.0f;
+  k.anzahlStuetzstellen = 2;
+  k.stuetzCode[0] = 500;
+  k.stuetzCode[1] = 500;   // nicht aufsteigend
+  TEST_ASSERT_FALSE(kalibrierungGueltig(k));
+  k.stuetzCode[1] = DAC_CODES;   // außerhalb
+  TEST_ASSERT_FALSE(kalibrierungGueltig(k));
+  k.stuetzCode[1] = 600;
+  TEST_ASSERT_TRUE(kalibrierungGueltig(k));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_standard_ist_identitaet);
+  RUN_TEST(test_gain_und_offset_gerundet);
+  RUN_TEST(test_begrenzung_auf_den_codebereich);
+  RUN_TEST(test_stuetzstellen_linear_interpoliert_und_randwerte_gehalten);
+  RUN_TEST(test_gueltigkeit);
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+// Benchmark Kanaltabelle: Zugriff über std::array in Hardware-Reihenfolge
+// gegenüber der früheren Map mit Kanalnamen als Schlüssel (std::string statt
+// Arduino-String). Beide Varianten müssen dieselben Codes liefern.
+#include <unity.h>
+#include <stdio.h>
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "Skalierung.hpp"
+
+#define KANAELE      16
+#define SAMPLES      4096
+#define DURCHLAEUFE  20
+
+struct Eintrag {
+  std::vector<Q15> samples;
+  KanalSkalierung skalierung;
+};
+
+static std::string name(uint8_t kanal) { return std::string("CH_") + (char)('A' + kanal); }
+
+static Eintrag eintrag(uint8_t kanal) {
+  Eintrag e;
+  e.samples.resize(SAMPLES);
+  for (uint32_t i = 0; i < SAMPLES; ++i) e.samples[i] = Q15::ausRoh((int16_t)((i * 97 + kanal * 1031) & 0xFFFF));
+  return e;
+}
+
+template <typename Frame>
+static double messe(Frame frame, uint64_t& summe) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t d = 0; d < DURCHLAEUFE; ++d)
+    for (uint32_t i = 0; i < SAMPLES; ++i) summe += frame(i);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+         ((double)DURCHLAEUFE * SAMPLES);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_tabelle_gegen_map() {
+  std::map<std::string, Eintrag> map;
+  std::array<Eintrag, KANAELE> tabelle;
+  for (uint8_t k = 0; k < KANAELE; ++k) {
+    map[name(k)] = eintrag(k);
+    tabelle[k] = eintrag(k);
+  }
+
+  // Früherer Pfad: Name pro Kanal und Frame bilden und nachschlagen
+  uint64_t summeSuche = 0;
+  const double suche = messe([&](uint32_t i) {
+    uint32_t s = 0;
+    for (uint8_t k = 0; k < KANAELE; ++k) s += codeAusQ15(map.find(name(k))->second.samples[i]);
+    return s;
+  }, summeSuche);
+
+  // Iteration über die Map (Reihenfolge nach Namen, Knoten verstreut im Heap)
+  uint64_t summeMap = 0;
+  const double iteration = messe([&](uint32_t i) {
+    uint32_t s = 0;
+    for (const auto& [_, e] : map) s += codeAusQ15(e.samples[i]);
+    return s;
+  }, summeMap);
+
+  // Kanaltabelle: Index = DAC-Kanal
+  uint64_t summeTabelle = 0;
+  const double feld = messe([&](uint32_t i) {
+    uint32_t s = 0;
+    for (uint8_t k = 0; k < KANAELE; ++k) s += codeAusQ15(tabelle[k].samples[i]);
+    return s;
+  }, summeTabelle);
+
+  char text[200];
+  snprintf(text, sizeof(text),
+           "%u Kanäle, ns pro Frame: Map-Suche %.1f, Map-Iteration %.1f, Tabelle %.1f (%.1fx / %.1fx)",
+           KANAELE, suche, iteration, feld, suche / feld, iteration / feld);
+  TEST_MESSAGE(text);
+  TEST_ASSERT_EQUAL_UINT64(summeSuche, summeTabelle);
+  TEST_ASSERT_EQUAL_UINT64(summeMap, summeTabelle);
+}
+
+// Hardware-Reihenfolge: Map sortiert ab 10 Kanälen nach Text ("CH_10" < "CH_2")
+void test_reihenfolge() {
+  std::map<std::string, uint8_t> map;
+  for (uint8_t k = 0; k < 12; ++k) map["CH_" + std::to_string(k)] = k;
+  uint8_t erwartet = 0;
+  bool sortiert = true;
+  for (const auto& [_, k] : map) sortiert &= (k == erwartet++);
+  TEST_ASSERT_FALSE(sortiert);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_tabelle_gegen_map);
+  RUN_TEST(test_reihenfolge);
+  return UNITY_END();
+}
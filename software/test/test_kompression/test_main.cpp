@@ -0,0 +1,139 @@
+// Host-Tests für das .eegz-Format (Kompression.hpp): Rundlauf, Rundung auf
+// 1 µV, Einzelblock-Zugriff sowie Kompressionsrate und Durchsatz als Benchmark
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "Kompression.hpp"
+
+// EEG-ähnliches Signal in mV (Alpha, langsame Welle, Rauschen), auf 'stellen'
+// Nachkommastellen gerundet wie in einer Textdatei
+static std::vector<float> eegSignal(size_t anzahl, int stellen, size_t& textBytes) {
+  std::mt19937 zufall(1234);
+  std::normal_distribution<float> rauschen(0.0f, 0.004f);
+  std::vector<float> werte(anzahl);
+  textBytes = 0;
+  char zeile[32];
+  for (size_t i = 0; i < anzahl; ++i) {
+    const float t = i / 250.0f;
+    const float x = 0.05f * sinf(2 * M_PI * 10 * t) + 0.02f * sinf(2 * M_PI * 1.3f * t) + rauschen(zufall);
+    textBytes += snprintf(zeile, sizeof(zeile), "%.*f\n", stellen, x);
+    werte[i] = strtof(zeile, nullptr);
+  }
+  return werte;
+}
+
+static KompressionsHeader leseHeader(const std::vector<uint8_t>& daten) {
+  KompressionsHeader h;
+  TEST_ASSERT_TRUE(pruefeKompressionsHeader(daten.data(), daten.size(), h));
+  return h;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_rundlauf_drei_nachkommastellen_exakt() {
+  size_t textBytes;
+  std::vector<float> werte = eegSignal(10000, 3, textBytes);
+  std::vector<uint8_t> daten;
+  TEST_ASSERT_TRUE(kodiereSamples(werte.data(), werte.size(), daten));
+  TEST_ASSERT_EQUAL_UINT32(1000, leseHeader(daten).teilerProMv);
+
+  std::vector<float> zurueck;
+  TEST_ASSERT_TRUE(dekodiereSamples(daten.data(), daten.size(), zurueck));
+  TEST_ASSERT_EQUAL(werte.size(), zurueck.size());
+  for (size_t i = 0; i < werte.size(); ++i) TEST_ASSERT_EQUAL_FLOAT(werte[i], zurueck[i]);
+}
+
+void test_groebste_stufe_fuer_zwei_nachkommastellen() {
+  size_t textBytes;
+  std::vector<float> werte = eegSignal(1000, 2, textBytes);
+  std::vector<uint8_t> daten;
+  TEST_ASSERT_TRUE(kodiereSamples(werte.data(), werte.size(), daten));
+  TEST_ASSERT_EQUAL_UINT32(100, leseHeader(daten).teilerProMv);
+}
+
+void test_feinere_werte_werden_auf_1uv_gerundet_und_gemeldet() {
+  const float werte[] = {0.0f, 0.0012345f, -0.5f, 1.23456f, 2.0f};
+  const size_t anzahl = sizeof(werte) / sizeof(werte[0]);
+  std::vector<uint8_t> daten;
+  TEST_ASSERT_FALSE(kodiereSamples(werte, anzahl, daten));
+
+  std::vector<float> zurueck;
+  TEST_ASSERT_TRUE(dekodiereSamples(daten.data(), daten.size(), zurueck));
+  for (size_t i = 0; i < anzahl; ++i) TEST_ASSERT_FLOAT_WITHIN(0.0005f + 1e-6f, werte[i], zurueck[i]);
+  TEST_ASSERT_EQUAL_FLOAT(0.001f, zurueck[1]);
+}
+
+void test_einzelner_block_ueber_offset_tabelle() {
+  size_t textBytes;
+  std::vector<float> werte = eegSignal(1000, 3, textBytes);   // 3 volle Blöcke + Rest
+  std::vector<uint8_t> daten;
+  kodiereSamples(werte.data(), werte.size(), daten);
+  const KompressionsHeader h = leseHeader(daten);
+  TEST_ASSERT_EQUAL_UINT32(4, h.blockAnzahl);
+
+  const size_t tabelleEnde = sizeof(h) + h.blockAnzahl * sizeof(uint32_t);
+  for (uint32_t b = 0; b < h.blockAnzahl; ++b) {
+    uint32_t offset;
+    memcpy(&offset, &daten[sizeof(h) + b * sizeof(uint32_t)], sizeof(offset));
+    const size_t beginn = b * h.blockGroesse;
+    const size_t n = std::min<size_t>(h.blockGroesse, werte.size() - beginn);
+    std::vector<int32_t> q(h.blockGroesse);
+    TEST_ASSERT_EQUAL(n, dekodiereBlock(&daten[tabelleEnde + offset], daten.size() - tabelleEnde - offset, n, q.data()));
+    for (size_t i = 0; i < n; ++i) TEST_ASSERT_EQUAL_FLOAT(werte[beginn + i], q[i] / (float)h.teilerProMv);
+  }
+}
+
+void test_beschaedigte_daten_werden_erkannt() {
+  size_t textBytes;
+  std::vector<float> werte = eegSignal(600, 3, textBytes);
+  std::vector<uint8_t> daten;
+  kodiereSamples(werte.data(), werte.size(), daten);
+  std::vector<float> zurueck;
+  std::vector<uint8_t> kurz(daten.begin(), daten.begin() + daten.size() / 2);
+  TEST_ASSERT_FALSE(dekodiereSamples(kurz.data(), kurz.size(), zurueck));
+  daten[0] ^= 0xFF;
+  TEST_ASSERT_FALSE(dekodiereSamples(daten.data(), daten.size(), zurueck));
+}
+
+// Benchmark: Verhältnis zur Textdatei und Durchsatz von Kodierung/Dekodierung
+void test_benchmark_rate_und_durchsatz() {
+  using Uhr = std::chrono::steady_clock;
+  const size_t anzahl = 250 * 600;   // 10 min bei 250 Hz
+  size_t textBytes;
+  std::vector<float> werte = eegSignal(anzahl, 3, textBytes);
+
+  std::vector<uint8_t> daten;
+  auto t0 = Uhr::now();
+  kodiereSamples(werte.data(), werte.size(), daten);
+  auto t1 = Uhr::now();
+  std::vector<float> zurueck;
+  TEST_ASSERT_TRUE(dekodiereSamples(daten.data(), daten.size(), zurueck));
+  auto t2 = Uhr::now();
+
+  const double rate = (double)textBytes / daten.size();
+  const double kodierMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+  const double dekodierMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+  char meldung[200];
+  snprintf(meldung, sizeof(meldung), "%zu Samples: Text %zu B -> %zu B (%.2f:1, %.2f Bit/Sample), "
+           "kodieren %.1f MS/s, dekodieren %.1f MS/s", anzahl, textBytes, daten.size(), rate,
+           8.0 * daten.size() / anzahl, anzahl / kodierMs / 1e3, anzahl / dekodierMs / 1e3);
+  TEST_MESSAGE(meldung);
+  // Residuen des Rauschens (4 µV) brauchen etwa 6 Bit; Text braucht 6-7 Zeichen
+  TEST_ASSERT_GREATER_THAN(4.0, rate);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_rundlauf_drei_nachkommastellen_exakt);
+  RUN_TEST(test_groebste_stufe_fuer_zwei_nachkommastellen);
+  RUN_TEST(test_feinere_werte_werden_auf_1uv_gerundet_und_gemeldet);
+  RUN_TEST(test_einzelner_block_ueber_offset_tabelle);
+  RUN_TEST(test_beschaedigte_daten_werden_erkannt);
+  RUN_TEST(test_benchmark_rate_und_durchsatz);
+  return UNITY_END();
+}
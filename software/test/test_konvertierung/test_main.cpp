@@ -0,0 +1,145 @@
+// Tests für konvertiereBlock(): SIMD-Fassung (SSE2 auf dem Host, PIE auf dem
+// ESP32-S3 über pio test -e pie) bitgleich zur skalaren Referenz, dazu der
+// Durchsatz beider Varianten
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "Skalierung.hpp"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#define BENCHMARK_DURCHLAEUFE  20
+#else
+#define BENCHMARK_DURCHLAEUFE  2000
+#endif
+
+#ifdef __SSE2__
+#define VARIANTE  "SSE2"
+#elif defined(CONFIG_IDF_TARGET_ESP32S3)
+#define VARIANTE  "PIE"
+#else
+#define VARIANTE  "Block"
+#endif
+
+// Alle 65536 Q15-Werte in Blöcken der Wiedergabegröße
+static std::vector<Q15> alleWerte() {
+  std::vector<Q15> q(65536);
+  for (uint32_t i = 0; i < q.size(); ++i) q[i] = Q15::ausRoh((int16_t)(uint16_t)i);
+  return q;
+}
+
+static std::vector<uint16_t> beispielLut() {
+  std::vector<uint16_t> lut(DAC_MAX_CODE + 1);
+  for (uint32_t c = 0; c <= DAC_MAX_CODE; ++c) lut[c] = (uint16_t)((c * 4093 + 1000) / 4095);
+  return lut;
+}
+
+static void vergleiche(const uint16_t* lut) {
+  const std::vector<Q15> q = alleWerte();
+  std::vector<uint16_t> simd(q.size()), skalar(q.size());
+  for (size_t i = 0; i < q.size(); i += KONVERTIERUNG_BLOCK) {
+    konvertiereBlock(&q[i], KONVERTIERUNG_BLOCK, lut, &simd[i]);
+    konvertiereBlockSkalar(&q[i], KONVERTIERUNG_BLOCK, lut, &skalar[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(skalar.data(), simd.data(), q.size());
+  for (size_t i = 0; i < q.size(); ++i) {
+    uint16_t code = codeAusQ15(q[i]);
+    TEST_ASSERT_EQUAL_UINT16(lut ? lut[code] : code, skalar[i]);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_bitgleich_ohne_lut() { vergleiche(nullptr); }
+
+void test_bitgleich_mit_lut() {
+  const std::vector<uint16_t> lut = beispielLut();
+  vergleiche(lut.data());
+}
+
+// Restlängen, die nicht durch 8 bzw. 4 teilbar sind
+void test_restlaengen() {
+  const std::vector<Q15> q = alleWerte();
+  const std::vector<uint16_t> lut = beispielLut();
+  for (size_t n = 0; n <= 2 * KONVERTIERUNG_BLOCK + 3; ++n) {
+    uint16_t simd[2 * KONVERTIERUNG_BLOCK + 3], skalar[2 * KONVERTIERUNG_BLOCK + 3];
+    const size_t start = 65536 - 37 - n;
+    konvertiereBlock(&q[start], n, lut.data(), simd);
+    konvertiereBlockSkalar(&q[start], n, lut.data(), skalar);
+    for (size_t i = 0; i < n; ++i) TEST_ASSERT_EQUAL_UINT16(skalar[i], simd[i]);
+  }
+}
+
+// Rechenweg von KonvertierungPie.S je 32-Bit-Wort (zwei Spuren) nachgebildet,
+// damit er auch ohne ESP32-S3 gegen codeAusQ15() geprüft ist
+static uint16_t pieSpur(int16_t roh, int16_t nachbar, bool obereSpur) {
+  auto addiereSaettigend = [](int16_t x) {
+    int32_t s = (int32_t)x + 8;
+    return (uint16_t)(s > 32767 ? 32767 : s);
+  };
+  const uint32_t unten = addiereSaettigend(obereSpur ? nachbar : roh) ^ 0x8000u;
+  const uint32_t oben = addiereSaettigend(obereSpur ? roh : nachbar) ^ 0x8000u;
+  const uint32_t wort = (uint32_t)((int32_t)((oben << 16) | unten) >> 4);   // EE.VSR.32
+  return (uint16_t)((obereSpur ? wort >> 16 : wort) & 0x0FFF);
+}
+
+void test_pie_rechenweg() {
+  const int16_t nachbarn[] = {-32768, -1, 0, 7, 8, 32759, 32760, 32767};
+  for (int32_t roh = -32768; roh <= 32767; ++roh) {
+    const uint16_t erwartet = codeAusQ15(Q15::ausRoh((int16_t)roh));
+    for (int16_t nachbar : nachbarn) {
+      TEST_ASSERT_EQUAL_UINT16(erwartet, pieSpur((int16_t)roh, nachbar, false));
+      TEST_ASSERT_EQUAL_UINT16(erwartet, pieSpur((int16_t)roh, nachbar, true));
+    }
+  }
+}
+
+template <typename Kern>
+static double nsProSample(Kern kern, const std::vector<Q15>& q, const uint16_t* lut, std::vector<uint16_t>& codes) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t d = 0; d < BENCHMARK_DURCHLAEUFE; ++d)
+    for (size_t i = 0; i < q.size(); i += KONVERTIERUNG_BLOCK) kern(&q[i], KONVERTIERUNG_BLOCK, lut, &codes[i]);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+         ((double)BENCHMARK_DURCHLAEUFE * q.size());
+}
+
+void test_benchmark() {
+  const std::vector<Q15> q = alleWerte();
+  const std::vector<uint16_t> lut = beispielLut();
+  std::vector<uint16_t> codes(q.size());
+  const double skalarRoh = nsProSample(konvertiereBlockSkalar, q, nullptr, codes);
+  const double simdRoh = nsProSample(konvertiereBlock, q, nullptr, codes);
+  const double skalarLut = nsProSample(konvertiereBlockSkalar, q, lut.data(), codes);
+  const double simdLut = nsProSample(konvertiereBlock, q, lut.data(), codes);
+  char text[200];
+  snprintf(text, sizeof(text),
+           "ns/Sample ohne LUT: skalar %.3f, %s %.3f; mit LUT: skalar %.3f, %s %.3f",
+           skalarRoh, VARIANTE, simdRoh, skalarLut, VARIANTE, simdLut);
+  TEST_MESSAGE(text);
+  TEST_ASSERT_EQUAL_UINT16(lut[codeAusQ15(q[0])], codes[0]);
+}
+
+static int fuehreTestsAus() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bitgleich_ohne_lut);
+  RUN_TEST(test_bitgleich_mit_lut);
+  RUN_TEST(test_restlaengen);
+  RUN_TEST(test_pie_rechenweg);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+  delay(2000);   // serielle Verbindung des Test-Runners abwarten
+  fuehreTestsAus();
+}
+
+void loop() {}
+#else
+int main() {
+  return fuehreTestsAus();
+}
+#endif
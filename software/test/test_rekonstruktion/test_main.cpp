@@ -0,0 +1,117 @@
+// Host-Tests für das Rekonstruktionsfilter (Rekonstruktion.hpp): Zeitbudget
+// des Ausgabetakts und Durchsatz von interpoliereBlock() gegenüber Echtzeit
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "Rekonstruktion.hpp"
+
+#define BENCHMARK_KANAELE    4
+#define BENCHMARK_TAKT_HZ    10000
+#define BENCHMARK_SEKUNDEN   10
+#define BLOCK                32
+
+static FilterEinstellung staerksteEinstellung() {
+  FilterEinstellung e;
+  e.faktor = FILTER_MAX_FAKTOR;
+  e.tapsProPhase = FILTER_MAX_TAPS_PRO_PHASE;
+  e.grenzfrequenz = 0.9f;
+  return e;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_budget_vier_kanaele_10khz() {
+  // Auch mit dem längsten Filter bleiben 4 Kanäle bei 10 kHz im Budget
+  TEST_ASSERT_GREATER_OR_EQUAL(BENCHMARK_TAKT_HZ, (int)maxAusgabetaktHz(staerksteEinstellung(), 4));
+  // Quelltakt 1000 Hz mit 8-facher Überabtastung = 8 kHz
+  TEST_ASSERT_GREATER_OR_EQUAL(1000 * FILTER_MAX_FAKTOR, (int)maxAusgabetaktHz(staerksteEinstellung(), 4));
+}
+
+void test_budget_waechst_mit_kanaelen() {
+  const FilterEinstellung e = staerksteEinstellung();
+  TEST_ASSERT_LESS_THAN(frameKostenNs(e, 32), frameKostenNs(e, 4));
+  TEST_ASSERT_LESS_THAN(maxAusgabetaktHz(e, 4), maxAusgabetaktHz(e, 32));
+  // Ohne Filter kostet ein Kanal nur Bus und Konvertierung
+  FilterEinstellung aus;
+  TEST_ASSERT_EQUAL_UINT32(TAKT_AUFWECKEN_NS + TAKT_UEBERNAHME_NS + 4 * TAKT_KANAL_NS, frameKostenNs(aus, 4));
+  char text[120];
+  snprintf(text, sizeof(text), "Budget mit %u Taps/Phase: 4 Kanäle %.0f Hz, 32 Kanäle %.0f Hz",
+           e.tapsProPhase, maxAusgabetaktHz(e, 4), maxAusgabetaktHz(e, 32));
+  TEST_MESSAGE(text);
+}
+
+void test_gleichanteil_bleibt() {
+  InterpolationsFilter filter;
+  entwerfeFilter(staerksteEinstellung(), filter);
+  FilterZustand zustand;
+  setzeFilterZustand(filter, zustand, 3000);
+  uint16_t ein[BLOCK], aus[BLOCK * FILTER_MAX_FAKTOR];
+  for (uint16_t& c : ein) c = 3000;
+  interpoliereBlock(filter, zustand, ein, BLOCK, aus);
+  for (uint16_t c : aus) TEST_ASSERT_UINT32_WITHIN(1, 3000, c);
+}
+
+// Impuls im ersten Quellsample: Maximum der Antwort nach der Gruppenlaufzeit
+// (danach richtet der Abspiel-Task die Marker aus)
+void test_gruppenlaufzeit() {
+  for (uint8_t faktor : {1, 2, 4, 8}) {
+    FilterEinstellung e = staerksteEinstellung();
+    e.faktor = faktor;
+    InterpolationsFilter filter;
+    entwerfeFilter(e, filter);
+    FilterZustand zustand;
+    setzeFilterZustand(filter, zustand, 2048);
+    uint16_t ein[BLOCK], aus[BLOCK * FILTER_MAX_FAKTOR];
+    for (uint16_t& c : ein) c = 2048;
+    ein[0] = 4000;
+    interpoliereBlock(filter, zustand, ein, BLOCK, aus);
+    size_t spitze = 0;
+    for (size_t n = 0; n < BLOCK * faktor; ++n) {
+      if (aus[n] > aus[spitze]) spitze = n;
+    }
+    TEST_ASSERT_UINT32_WITHIN(1, gruppenlaufzeit(filter), spitze);
+  }
+}
+
+// 4 Kanäle, Ausgabetakt 10 kHz (Quelltakt 1250 Hz, 8-fach): Rechenzeit
+// muss deutlich unter der abgespielten Zeit liegen
+void test_durchsatz_echtzeit() {
+  InterpolationsFilter filter;
+  entwerfeFilter(staerksteEinstellung(), filter);
+  FilterZustand zustand[BENCHMARK_KANAELE];
+  std::vector<uint16_t> ein(BLOCK);
+  std::vector<uint16_t> aus(BLOCK * filter.faktor);
+  const uint32_t quellSamples = BENCHMARK_TAKT_HZ / filter.faktor * BENCHMARK_SEKUNDEN;
+  uint64_t pruefsumme = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < quellSamples; i += BLOCK) {
+    for (uint8_t k = 0; k < BENCHMARK_KANAELE; ++k) {
+      for (uint32_t j = 0; j < BLOCK; ++j) ein[j] = (uint16_t)(((i + j) * 37 + k * 500) & 0x0FFF);
+      interpoliereBlock(filter, zustand[k], ein.data(), BLOCK, aus.data());
+      pruefsumme += aus[0];
+    }
+  }
+  const double sekunden = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  char text[160];
+  snprintf(text, sizeof(text), "%u Kanäle, %u Hz, %u Taps: %.1f ms für %u s (%.0fx Echtzeit, %.1f ns/Ausgabewert)",
+           BENCHMARK_KANAELE, BENCHMARK_TAKT_HZ, filter.faktor * filter.taps, sekunden * 1000.0,
+           BENCHMARK_SEKUNDEN, BENCHMARK_SEKUNDEN / sekunden,
+           sekunden * 1e9 / ((double)quellSamples * filter.faktor * BENCHMARK_KANAELE));
+  TEST_MESSAGE(text);
+  TEST_ASSERT_TRUE(pruefsumme > 0);
+  TEST_ASSERT_TRUE(sekunden < BENCHMARK_SEKUNDEN);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_budget_vier_kanaele_10khz);
+  RUN_TEST(test_budget_waechst_mit_kanaelen);
+  RUN_TEST(test_gleichanteil_bleibt);
+  RUN_TEST(test_gruppenlaufzeit);
+  RUN_TEST(test_durchsatz_echtzeit);
+  return UNITY_END();
+}
@@ -0,0 +1,120 @@
+// Host-Tests für die Bereichswahl pro Kanal (Skalierung.hpp): Code-Histogramme
+// eines µV-Signals und eines Signals mit großen Artefakten je Bereichsmodus
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <array>
+#include <random>
+#include <vector>
+#include "Skalierung.hpp"
+
+struct Histogramm {
+  std::array<uint32_t, DAC_MAX_CODE + 1> anzahl = {};
+  uint32_t belegteCodes = 0;
+  uint32_t unten = 0;    // Code 0 (begrenzt oder Minimum)
+  uint32_t oben = 0;     // Code 4095
+};
+
+// Wie im Abspielpfad: mV -> Q15 beim Laden, dann blockweise in DAC-Codes
+static Histogramm histogramm(const std::vector<float>& mv, const KanalSkalierung& s) {
+  std::vector<Q15> q(mv.size());
+  normiereBlock(mv.data(), mv.size(), s, q.data());
+  std::vector<uint16_t> codes(mv.size());
+  for (size_t i = 0; i < mv.size(); i += KONVERTIERUNG_BLOCK) {
+    const size_t n = std::min<size_t>(KONVERTIERUNG_BLOCK, mv.size() - i);
+    konvertiereBlock(&q[i], n, nullptr, &codes[i]);
+  }
+  Histogramm h;
+  for (uint16_t c : codes) h.anzahl[c]++;
+  for (uint32_t a : h.anzahl) h.belegteCodes += (a > 0);
+  h.unten = h.anzahl[0];
+  h.oben = h.anzahl[DAC_MAX_CODE];
+  return h;
+}
+
+static KanalSkalierung skalierung(BereichsModus modus, const std::vector<float>& mv, float minMv = 0, float maxMv = 0) {
+  if (modus == BereichsModus::AUTO) bestimmeBereich(mv.data(), mv.size(), minMv, maxMv);
+  return berechneSkalierung(modus, minMv, maxMv);
+}
+
+static void melde(const char* name, const Histogramm& h) {
+  char meldung[128];
+  snprintf(meldung, sizeof(meldung), "%s: %u Codes belegt, %u auf 0, %u auf 4095", name,
+           (unsigned)h.belegteCodes, (unsigned)h.unten, (unsigned)h.oben);
+  TEST_MESSAGE(meldung);
+}
+
+// 20 000 Samples gleichverteilt in ±50 µV
+static std::vector<float> mikrovoltSignal() {
+  std::mt19937 zufall(42);
+  std::uniform_real_distribution<float> verteilung(-0.05f, 0.05f);
+  std::vector<float> mv(20000);
+  for (float& x : mv) x = verteilung(zufall);
+  return mv;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_mikrovolt_signal_fest_nutzt_kaum_codes() {
+  std::vector<float> mv = mikrovoltSignal();
+  Histogramm fest = histogramm(mv, skalierung(BereichsModus::FEST, mv));
+  Histogramm autom = histogramm(mv, skalierung(BereichsModus::AUTO, mv));
+  melde("±50 µV, fest ±150 mV", fest);
+  melde("±50 µV, auto", autom);
+  // 100 µV Spanne bei 13,65 Codes/mV: 1-2 Codes
+  TEST_ASSERT_LESS_OR_EQUAL(3, fest.belegteCodes);
+  // Automatisch: praktisch der ganze Wertebereich
+  TEST_ASSERT_GREATER_OR_EQUAL(3500, autom.belegteCodes);
+  // Ränder nur mit ihrem Anteil einer Gleichverteilung (~5 pro Code), nichts begrenzt
+  TEST_ASSERT_LESS_OR_EQUAL(15, autom.unten);
+  TEST_ASSERT_LESS_OR_EQUAL(15, autom.oben);
+}
+
+void test_benutzerbereich_begrenzt_ausserhalb() {
+  std::vector<float> mv = mikrovoltSignal();
+  Histogramm h = histogramm(mv, skalierung(BereichsModus::BENUTZER, mv, -0.025f, 0.025f));
+  melde("±50 µV, user ±25 µV", h);
+  // Die Hälfte der Samples liegt über |25 µV| und landet auf den Rändern
+  TEST_ASSERT_UINT32_WITHIN(300, 10000, h.unten + h.oben);
+  TEST_ASSERT_GREATER_OR_EQUAL(3500, h.belegteCodes);
+}
+
+void test_artefakte_werden_fest_abgeschnitten_auto_nicht() {
+  // 100 µV EEG mit Blinzel-Artefakten von 400 mV
+  std::vector<float> mv = mikrovoltSignal();
+  for (size_t i = 0; i < mv.size(); i += 1000) {
+    for (size_t j = 0; j < 50 && i + j < mv.size(); ++j) mv[i + j] += 400.0f * sinf((float)M_PI * j / 50.0f);
+  }
+  Histogramm fest = histogramm(mv, skalierung(BereichsModus::FEST, mv));
+  Histogramm autom = histogramm(mv, skalierung(BereichsModus::AUTO, mv));
+  melde("Artefakte 400 mV, fest", fest);
+  melde("Artefakte 400 mV, auto", autom);
+  TEST_ASSERT_GREATER_THAN(100, fest.oben);       // Spitzen über 150 mV begrenzt
+  TEST_ASSERT_LESS_OR_EQUAL(20, autom.oben);      // nur die Scheitel selbst
+}
+
+void test_null_mv_liegt_auf_ruhecode() {
+  std::vector<float> mv = mikrovoltSignal();
+  const KanalSkalierung s = skalierung(BereichsModus::AUTO, mv);
+  TEST_ASSERT_INT_WITHIN(1, 2048, codeAusQ15(s.ruhe));
+  const KanalSkalierung fest = berechneSkalierung(BereichsModus::FEST, 0, 0);
+  TEST_ASSERT_INT_WITHIN(1, 2048, codeAusQ15(fest.ruhe));
+}
+
+void test_konstantes_signal_ohne_division_durch_null() {
+  std::vector<float> mv(100, 3.0f);
+  const KanalSkalierung s = skalierung(BereichsModus::AUTO, mv);
+  TEST_ASSERT_TRUE(isfinite(s.codesProMv));
+  TEST_ASSERT_GREATER_THAN(s.minMv, s.maxMv);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_mikrovolt_signal_fest_nutzt_kaum_codes);
+  RUN_TEST(test_benutzerbereich_begrenzt_ausserhalb);
+  RUN_TEST(test_artefakte_werden_fest_abgeschnitten_auto_nicht);
+  RUN_TEST(test_null_mv_liegt_auf_ruhecode);
+  RUN_TEST(test_konstantes_signal_ohne_division_durch_null);
+  return UNITY_END();
+}
@@ -0,0 +1,209 @@
+// Host-Test für die Slave-Nachführung (SyncNachfuehrung.hpp): ein simulierter
+// Master mit Drift, Jitter und verlorenen Pulsen, ein Slave mit gelegentlichen
+// Aussetzern. Jedes auf einen Puls ausgegebene Sample muss das Sample sein,
+// das der Master zu diesem Zeitpunkt ausgibt
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+#include "SyncNachfuehrung.hpp"
+
+#define PERIODE_US      1000                    // Quellperiode des Slaves
+#define TIMEOUT_US      (2 * PERIODE_US + 1000) // 2 Perioden + 1 Tick
+#define FRAME_US        40                      // Ausgabe eines Quellsamples
+#define AUSLASSEN_US    2
+#define PULSE           20000
+
+void setUp() {}
+void tearDown() {}
+
+static uint32_t zufall = 12345;
+static uint32_t naechsteZufallszahl() {
+  zufall = zufall * 1103515245u + 12345u;
+  return zufall >> 8;
+}
+
+struct Master {
+  std::vector<int64_t> zeitUs;
+  std::vector<bool> verloren;
+
+  // Periode mit Drift in ppm, Jitter gleichverteilt in ±jitterUs
+  Master(int32_t driftPpm, int32_t jitterUs, uint32_t verlustPromille, uint32_t doppelverlustAlle) {
+    const double periode = PERIODE_US * (1.0 + driftPpm * 1e-6);
+    for (uint32_t k = 0; k < PULSE; ++k) {
+      const int32_t jitter = jitterUs ? (int32_t)(naechsteZufallszahl() % (2 * jitterUs + 1)) - jitterUs : 0;
+      zeitUs.push_back(10000 + (int64_t)(k * periode) + jitter);
+      verloren.push_back(k > 0 && naechsteZufallszahl() % 1000 < verlustPromille);
+    }
+    for (uint32_t k = doppelverlustAlle; doppelverlustAlle && k + 1 < PULSE; k += doppelverlustAlle) {
+      verloren[k] = verloren[k + 1] = true;
+    }
+  }
+
+  // Sample, das der Master zum Zeitpunkt t ausgibt (-1 vor dem Start)
+  int64_t sampleBei(int64_t t) const {
+    int64_t k = -1;
+    while (k + 1 < (int64_t)zeitUs.size() && zeitUs[k + 1] <= t) k++;
+    return k;
+  }
+};
+
+struct Slave {
+  const Master& master;
+  int64_t jetztUs = 9500;   // kurz vor dem ersten Puls scharf geschaltet
+  size_t gelesen = 0;     // erster noch nicht gezählter Puls
+  uint32_t aussetzerAlle = 0;
+  int64_t aussetzerUs = 0;
+  uint32_t treffer = 0;
+  uint32_t fehlgriffe = 0;
+  uint32_t freilauf = 0;
+
+  explicit Slave(const Master& m) : master(m) {}
+
+  // Wie ulTaskNotifyTake + Zählerstand: blockiert bis zum nächsten Puls und
+  // zählt alle bis dahin aufgelaufenen
+  bool warten(uint32_t& anzahl, int64_t& pulsUs) {
+    size_t n = gelesen;
+    while (n < master.zeitUs.size() && master.verloren[n]) n++;
+    if (n >= master.zeitUs.size() || master.zeitUs[n] > jetztUs + TIMEOUT_US) {
+      jetztUs += TIMEOUT_US;
+      return false;
+    }
+    if (master.zeitUs[n] > jetztUs) jetztUs = master.zeitUs[n];
+    anzahl = 0;
+    for (; n < master.zeitUs.size() && master.zeitUs[n] <= jetztUs; ++n) {
+      if (master.verloren[n]) continue;
+      anzahl++;
+      pulsUs = master.zeitUs[n];
+    }
+    gelesen = n;
+    return true;
+  }
+
+  // Spielt bis kurz vor dem letzten Puls; liefert das letzte ausgegebene Sample
+  uint32_t spiele(SyncNachfuehrung& nf) {
+    uint32_t sample = 0;
+    uint32_t ausgegeben = 0;
+    while (sample + 10 < PULSE) {
+      const SyncSchritt schritt = nf.schritt(sample, PERIODE_US, [&](uint32_t& anzahl, int64_t& pulsUs) {
+        return warten(anzahl, pulsUs);
+      });
+      if (schritt == SyncSchritt::AUSLASSEN) {
+        jetztUs += AUSLASSEN_US;
+      } else {
+        if (schritt == SyncSchritt::ZEITUEBERSCHREITUNG) freilauf++;
+        else if (master.sampleBei(jetztUs) == (int64_t)sample) treffer++;
+        else fehlgriffe++;
+        jetztUs += FRAME_US;
+        ausgegeben++;
+        if (aussetzerAlle && ausgegeben % aussetzerAlle == 0) jetztUs += aussetzerUs;
+      }
+      sample++;
+    }
+    return sample - 1;
+  }
+};
+
+void test_puls_fuer_puls() {
+  Master master(0, 0, 0, 0);
+  Slave slave(master);
+  SyncNachfuehrung nf;
+  slave.spiele(nf);
+  TEST_ASSERT_EQUAL_UINT32(0, slave.fehlgriffe);
+  TEST_ASSERT_EQUAL_UINT32(0, slave.freilauf);
+  TEST_ASSERT_EQUAL_UINT32(0, nf.ausgelassen);
+  TEST_ASSERT_EQUAL_UINT32(PULSE - 10, slave.treffer);
+}
+
+// Aussetzer über mehrere Perioden: die aufgelaufenen Pulse werden nicht nur
+// gezählt, sondern durch Auslassen aufgeholt
+void test_rueckstand_wird_aufgeholt() {
+  Master master(0, 0, 0, 0);
+  Slave slave(master);
+  slave.aussetzerAlle = 997;
+  slave.aussetzerUs = 3300;
+  SyncNachfuehrung nf;
+  const uint32_t letztes = slave.spiele(nf);
+  TEST_ASSERT_EQUAL_UINT32(0, slave.fehlgriffe);
+  TEST_ASSERT_TRUE(nf.rueckstand > 0);
+  TEST_ASSERT_EQUAL_UINT32(nf.rueckstand, nf.ausgelassen);
+  TEST_ASSERT_EQUAL_INT64(master.sampleBei(slave.jetztUs - FRAME_US), (int64_t)letztes);
+}
+
+// Verlorener Puls: der nächste zählt nach seinem Abstand für zwei Samples
+void test_verlorener_puls() {
+  SyncNachfuehrung nf;
+  TEST_ASSERT_EQUAL_UINT32(0, nf.puls(1, 0, PERIODE_US));
+  TEST_ASSERT_EQUAL_UINT32(1, nf.puls(1, 1010, PERIODE_US));
+  TEST_ASSERT_EQUAL_UINT32(3, nf.puls(1, 2990, PERIODE_US));
+  TEST_ASSERT_EQUAL_UINT32(5, nf.puls(2, 5000, PERIODE_US));
+}
+
+// Nach einer Zeitüberschreitung läuft ein Sample im eigenen Takt; kommt der
+// Puls dafür verspätet, wartet der Slave auf den nächsten statt voraus zu bleiben
+void test_nach_zeitueberschreitung_neu_ausrichten() {
+  SyncNachfuehrung nf;
+  std::vector<int64_t> pulse = {0, 1000, 2000, 3000, 4000, -1, 5100, 6000};
+  size_t n = 0;
+  auto warten = [&](uint32_t& anzahl, int64_t& pulsUs) {
+    if (pulse[n] < 0) {
+      n++;
+      return false;
+    }
+    anzahl = 1;
+    pulsUs = pulse[n++];
+    return true;
+  };
+  for (uint32_t s = 0; s < 5; ++s) TEST_ASSERT_TRUE(nf.schritt(s, PERIODE_US, warten) == SyncSchritt::AUSGEBEN);
+  TEST_ASSERT_TRUE(nf.schritt(5, PERIODE_US, warten) == SyncSchritt::ZEITUEBERSCHREITUNG);
+  TEST_ASSERT_TRUE(nf.schritt(6, PERIODE_US, warten) == SyncSchritt::AUSGEBEN);
+  TEST_ASSERT_EQUAL_UINT32(1, nf.gehalten);
+  TEST_ASSERT_EQUAL_UINT32(6, nf.masterSample);
+  TEST_ASSERT_EQUAL_size_t(pulse.size(), n);
+}
+
+// Drift, Jitter, einzelne und doppelte Pulsverluste und Aussetzer zusammen;
+// zum Vergleich der bisherige Slave, der pro Aufwachen ein Sample ausgibt
+void test_drift_und_jitter() {
+  Master master(500, 200, 5, 2503);
+  Slave slave(master);
+  slave.aussetzerAlle = 1009;
+  slave.aussetzerUs = 2700;
+  SyncNachfuehrung nf;
+  const uint32_t letztes = slave.spiele(nf);
+  TEST_ASSERT_EQUAL_UINT32(0, slave.fehlgriffe);
+  TEST_ASSERT_TRUE(slave.freilauf <= PULSE / 2503 + 1);
+  const int64_t versatz = master.sampleBei(slave.jetztUs - FRAME_US) - (int64_t)letztes;
+  TEST_ASSERT_TRUE(versatz >= 0 && versatz <= 1);
+
+  Slave alt(master);
+  alt.aussetzerAlle = slave.aussetzerAlle;
+  alt.aussetzerUs = slave.aussetzerUs;
+  uint32_t sampleAlt = 0;
+  for (uint32_t s = 0; s + 10 < PULSE && alt.gelesen < PULSE; ++s) {
+    uint32_t anzahl = 0;
+    int64_t pulsUs = 0;
+    alt.warten(anzahl, pulsUs);
+    alt.jetztUs += FRAME_US;
+    if ((s + 1) % alt.aussetzerAlle == 0) alt.jetztUs += alt.aussetzerUs;
+    sampleAlt = s;
+  }
+  const int64_t versatzAlt = alt.master.sampleBei(alt.jetztUs) - (int64_t)sampleAlt;
+
+  char text[200];
+  snprintf(text, sizeof(text),
+           "%u Pulse: %u Treffer, %u im Freilauf, %u ausgelassen, %u gehalten; "
+           "Versatz am Ende %lld Samples (ohne Nachführung %lld)",
+           PULSE, slave.treffer, slave.freilauf, nf.ausgelassen, nf.gehalten,
+           (long long)versatz, (long long)versatzAlt);
+  TEST_MESSAGE(text);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_puls_fuer_puls);
+  RUN_TEST(test_rueckstand_wird_aufgeholt);
+  RUN_TEST(test_verlorener_puls);
+  RUN_TEST(test_nach_zeitueberschreitung_neu_ausrichten);
+  RUN_TEST(test_drift_und_jitter);
+  return UNITY_END();
+}
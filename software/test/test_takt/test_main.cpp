@@ -0,0 +1,114 @@
+// Host-Test für den Ausgabetakt (Takt.hpp): Ratengenauigkeit über lange
+// Laufzeiten, auch bei gebrochenen Frequenzen, und Verhalten bei Verspätung
+// mit simulierter Uhr
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include "Takt.hpp"
+
+void setUp() {}
+void tearDown() {}
+
+static uint32_t zufall = 2024;
+static uint32_t naechsteZufallszahl() {
+  zufall = zufall * 1103515245u + 12345u;
+  return zufall >> 8;
+}
+
+// Eine Stunde Fristen: höchstens 1 µs neben der exakten Zeit
+static double abweichungNachStundeUs(float hz) {
+  Takt takt;
+  setzePeriode(takt, hz);
+  const uint64_t perioden = (uint64_t)llround(hz * 3600.0);
+  for (uint64_t n = 0; n < perioden; ++n) naechsteFrist(takt);
+  const double exakt = perioden * (1e6 / hz);
+  return fabs((double)takt.fristUs + takt.fristBruch / 4294967296.0 - exakt);
+}
+
+void test_rate_ueber_eine_stunde() {
+  const float raten[] = {1.0f, 100.0f, 333.333f, 512.5f, 999.9f, 1000.0f, 8000.0f};
+  for (float hz : raten) {
+    const double fehler = abweichungNachStundeUs(hz);
+    char text[96];
+    snprintf(text, sizeof(text), "%.3f Hz: %.3f µs nach einer Stunde", hz, fehler);
+    TEST_ASSERT_TRUE_MESSAGE(fehler <= 1.0, text);
+  }
+  // Zum Vergleich: ganzzahlige Periode (1951 µs statt 1951.2195 µs)
+  const double ganzzahlig = 512.5 * 3600.0 * (1e6 / 512.5 - 1951.0);
+  char text[96];
+  snprintf(text, sizeof(text), "512.5 Hz mit ganzzahliger Periode: %.0f µs Drift pro Stunde", ganzzahlig);
+  TEST_MESSAGE(text);
+}
+
+// Knapp verspätet: die Frist bleibt, der nächste Frame holt den Rückstand auf
+void test_verspaetung_unter_einer_periode() {
+  Takt takt;
+  setzePeriode(takt, 1000.0f);
+  takt.fristUs = 10000;
+  TEST_ASSERT_EQUAL_INT64(-600, restBisFrist(takt, 10600));
+  TEST_ASSERT_EQUAL_INT64(10000, takt.fristUs);
+  naechsteFrist(takt);
+  TEST_ASSERT_EQUAL_INT64(400, restBisFrist(takt, 10600));
+}
+
+// Mehr als eine Periode zurück: neu aufsetzen statt Frames nachzuholen
+void test_verspaetung_ueber_einer_periode() {
+  Takt takt;
+  setzePeriode(takt, 512.5f);
+  takt.fristUs = 10000;
+  takt.fristBruch = 12345;
+  TEST_ASSERT_TRUE(restBisFrist(takt, 15000) < 0);
+  TEST_ASSERT_EQUAL_INT64(15000, takt.fristUs);
+  TEST_ASSERT_EQUAL_UINT32(0, takt.fristBruch);
+  naechsteFrist(takt);
+  TEST_ASSERT_EQUAL_INT64(15000 + 1951, takt.fristUs);
+}
+
+// Abspielschleife mit simulierter Uhr: Aufwachlatenz 0..40 µs, Schreiben 20 µs,
+// alle 5000 Frames eine Blockumrechnung über 3 Perioden. Kein Frame vor seiner
+// Frist; zwischen den Ausreißern läuft die Rate exakt
+void test_simulierte_wiedergabe() {
+  const float hz = 512.5f;
+  Takt takt;
+  setzePeriode(takt, hz);
+  int64_t jetzt = 0;
+  takt.fristUs = 0;
+  int64_t letzterNeustartUs = 0;
+  uint32_t framesSeitNeustart = 0;
+  uint32_t neustarts = 0;
+  int64_t maxVerspaetungUs = 0;
+  for (uint32_t frame = 0; frame < 200000; ++frame) {
+    const int64_t rest = restBisFrist(takt, jetzt);
+    if (rest > 0) jetzt += rest + naechsteZufallszahl() % 41;
+    if (rest < -(int64_t)takt.periodeUs) {
+      neustarts++;
+      letzterNeustartUs = takt.fristUs;
+      framesSeitNeustart = 0;
+    }
+    TEST_ASSERT_TRUE(jetzt >= takt.fristUs);
+    if (rest > 0 && jetzt - takt.fristUs > maxVerspaetungUs) maxVerspaetungUs = jetzt - takt.fristUs;
+    jetzt += 20;
+    if (frame % 5000 == 4999) jetzt += 3 * takt.periodeUs;
+    framesSeitNeustart++;
+    naechsteFrist(takt);
+  }
+  // Frist des nächsten Frames gegenüber der exakten Rechnung seit dem letzten Neustart
+  const double exakt = letzterNeustartUs + framesSeitNeustart * (1e6 / hz);
+  TEST_ASSERT_TRUE(fabs((double)takt.fristUs - exakt) <= 1.0);
+  // Der Überlauf im letzten Frame wirkt erst danach
+  TEST_ASSERT_EQUAL_UINT32(200000 / 5000 - 1, neustarts);
+  TEST_ASSERT_TRUE(maxVerspaetungUs <= 40);
+  char text[96];
+  snprintf(text, sizeof(text), "%u Neustarts nach Überlauf, größte Verspätung %lld µs",
+           neustarts, (long long)maxVerspaetungUs);
+  TEST_MESSAGE(text);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_rate_ueber_eine_stunde);
+  RUN_TEST(test_verspaetung_unter_einer_periode);
+  RUN_TEST(test_verspaetung_ueber_einer_periode);
+  RUN_TEST(test_simulierte_wiedergabe);
+  return UNITY_END();
+}
@@ -0,0 +1,109 @@
+// Host-Test und Benchmark für den schrittweisen Zahlenleser (Zahlenleser.hpp)
+// mit einem synthetischen Datenstrom in Upload-Stücken: jede Stückelung liefert
+// dieselben Zahlen wie strtod() auf dem ganzen Text
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "Zahlenleser.hpp"
+
+#define ZAHLEN  200000
+
+void setUp() {}
+void tearDown() {}
+
+// EEG-ähnlicher Text: Alpha-Sinus mit Rauschen in mV, drei Nachkommastellen,
+// gemischte Zeilenenden und Trenner
+static std::string synthetischerText(std::vector<float>& erwartet) {
+  std::string text;
+  uint32_t zufall = 99;
+  char zahl[32];
+  for (int i = 0; i < ZAHLEN; ++i) {
+    zufall = zufall * 1103515245u + 12345u;
+    const double rauschen = ((zufall >> 8) % 2001 - 1000) / 20000.0;
+    const double mv = 0.05 * sin(2.0 * M_PI * 10.0 * i / 500.0) + rauschen;
+    snprintf(zahl, sizeof(zahl), "%.3f", mv);
+    erwartet.push_back((float)strtod(zahl, nullptr));
+    text += zahl;
+    text += (i % 3 == 0) ? "\r\n" : (i % 3 == 1) ? "\n" : ", ";
+  }
+  return text;
+}
+
+static std::vector<float> leseInStuecken(const std::string& text, size_t stueck) {
+  Zahlenleser leser;
+  std::vector<float> werte;
+  std::vector<float> teil;
+  for (size_t i = 0; i < text.size(); i += stueck) {
+    const size_t n = (text.size() - i < stueck) ? text.size() - i : stueck;
+    teil.clear();
+    leser.verarbeite((const uint8_t*)text.data() + i, n, teil);
+    // Obergrenze, mit der der Upload-Puffer rechnet
+    TEST_ASSERT_TRUE(teil.size() <= n / 2 + 1);
+    werte.insert(werte.end(), teil.begin(), teil.end());
+  }
+  leser.beende(werte);
+  TEST_ASSERT_EQUAL_size_t(text.size(), leser.gelesenBytes());
+  return werte;
+}
+
+void test_stueckelung_egal() {
+  std::vector<float> erwartet;
+  const std::string text = synthetischerText(erwartet);
+  const size_t stuecke[] = {1, 2, 7, 64, 536, 1436, 4096, text.size()};
+  for (size_t stueck : stuecke) {
+    const std::vector<float> werte = leseInStuecken(text, stueck);
+    TEST_ASSERT_EQUAL_size_t(erwartet.size(), werte.size());
+    for (size_t i = 0; i < werte.size(); ++i) TEST_ASSERT_EQUAL_FLOAT(erwartet[i], werte[i]);
+  }
+}
+
+void test_sonderfaelle() {
+  const char* text = "12. -3 - 4 abc-5.25x1e3 7";
+  Zahlenleser leser;
+  std::vector<float> werte;
+  leser.verarbeite((const uint8_t*)text, strlen(text), werte);
+  leser.beende(werte);
+  const float erwartet[] = {12.0f, -3.0f, 4.0f, -5.25f, 1.0f, 3.0f, 7.0f};
+  TEST_ASSERT_EQUAL_size_t(sizeof(erwartet) / sizeof(erwartet[0]), werte.size());
+  for (size_t i = 0; i < werte.size(); ++i) TEST_ASSERT_EQUAL_FLOAT(erwartet[i], werte[i]);
+}
+
+// Dichtester Text: jedes zweite Zeichen eine Zahl
+void test_dichtester_text() {
+  std::string text;
+  for (int i = 0; i < 1000; ++i) text += "1 ";
+  const std::vector<float> werte = leseInStuecken(text, 3);
+  TEST_ASSERT_EQUAL_size_t(1000, werte.size());
+}
+
+void test_benchmark() {
+  std::vector<float> erwartet;
+  const std::string text = synthetischerText(erwartet);
+  const size_t stuecke[] = {536, 1436};
+  for (size_t stueck : stuecke) {
+    const auto start = std::chrono::steady_clock::now();
+    const int durchlaeufe = 5;
+    size_t anzahl = 0;
+    for (int d = 0; d < durchlaeufe; ++d) anzahl += leseInStuecken(text, stueck).size();
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL_size_t(erwartet.size() * durchlaeufe, anzahl);
+    char meldung[120];
+    snprintf(meldung, sizeof(meldung), "Stücke zu %zu Bytes: %.1f MB/s, %.2f Mio. Zahlen/s (Host)",
+             stueck, text.size() * durchlaeufe / s / 1e6, anzahl / s / 1e6);
+    TEST_MESSAGE(meldung);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_stueckelung_egal);
+  RUN_TEST(test_sonderfaelle);
+  RUN_TEST(test_dichtester_text);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,133 @@
+// Host-Test für Kanäle mit eigener Abtastrate (KanalZeitachse.hpp): Lage auf
+// der gemeinsamen Zeitachse, Drift über lange Laufzeiten, blockweises Abtasten
+// und Interpolation gegenüber der exakten Rechnung
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "KanalZeitachse.hpp"
+
+#define BLOCK  32
+
+void setUp() {}
+void tearDown() {}
+
+static std::vector<Q15> sinusSamples(size_t anzahl, double periodeSamples) {
+  std::vector<Q15> s(anzahl);
+  for (size_t i = 0; i < anzahl; ++i) s[i] = Q15::ausFloat((float)(0.9 * sin(2.0 * M_PI * i / periodeSamples)));
+  return s;
+}
+
+void test_gleicher_takt_direkt() {
+  const KanalZeitachse za = berechneZeitachse(0.0f, 0.0f, 500.0f);
+  TEST_ASSERT_TRUE(za.direkt);
+  TEST_ASSERT_TRUE(berechneZeitachse(500.0f, 0.0f, 500.0f).direkt);
+  TEST_ASSERT_EQUAL_size_t(1000, zeitachsenLaenge(1000, za));
+}
+
+void test_startversatz() {
+  const KanalZeitachse za = berechneZeitachse(250.0f, 1.5f, 512.5f);
+  TEST_ASSERT_EQUAL_size_t(769, za.beginn);   // 1.5 s * 512.5 Hz = 768.75
+  TEST_ASSERT_FALSE(za.direkt);
+  TEST_ASSERT_EQUAL_size_t(0, berechneZeitachse(0.0f, -1.0f, 500.0f).beginn);
+  TEST_ASSERT_EQUAL_size_t(0, berechneZeitachse(0.0f, NAN, 500.0f).beginn);
+}
+
+// Eine Stunde bei 512.5 Hz: die Kanalposition weicht höchstens um den
+// Rundungsrest des Schritts (< 2^-32 pro Sample) von n * Rate / Takt ab
+void test_keine_drift_ueber_eine_stunde() {
+  const float raten[][2] = {{256.0f, 512.5f}, {1000.0f, 512.5f}, {200.0f, 333.333f}, {8000.0f, 1000.0f}};
+  for (const auto& r : raten) {
+    const KanalZeitachse za = berechneZeitachse(r[0], 0.0f, r[1]);
+    const size_t n = (size_t)(r[1] * 3600.0f);
+    KanalPhase phase(za, 0);
+    for (size_t i = 0; i < n; ++i) phase.weiter(za);
+    const KanalPhase direkt(za, n);
+    TEST_ASSERT_EQUAL_UINT32(direkt.pos, phase.pos);
+    TEST_ASSERT_EQUAL_UINT32(direkt.bruch, phase.bruch);
+    const double exakt = (double)n * r[0] / r[1];
+    const double ist = phase.pos + phase.bruch / 4294967296.0;
+    char text[96];
+    snprintf(text, sizeof(text), "%.0f Hz auf %.3f Hz: %.2e Samples Abweichung", r[0], r[1], exakt - ist);
+    TEST_ASSERT_TRUE_MESSAGE(fabs(exakt - ist) < 1e-3, text);
+  }
+}
+
+// Die Länge deckt genau die Ausgabesamples ab, deren Position im Kanal liegt
+void test_laenge() {
+  const KanalZeitachse za = berechneZeitachse(300.0f, 0.2f, 512.5f);
+  const size_t groesse = 1234;
+  const size_t laenge = zeitachsenLaenge(groesse, za);
+  TEST_ASSERT_TRUE(KanalPhase(za, laenge - 1 - za.beginn).pos < groesse);
+  TEST_ASSERT_TRUE(KanalPhase(za, laenge - za.beginn).pos >= groesse);
+}
+
+// Blockweise ab beliebigem Sample dasselbe wie in einem Stück
+void test_bloecke_wie_am_stueck() {
+  const std::vector<Q15> samples = sinusSamples(997, 37.3);
+  const KanalZeitachse za = berechneZeitachse(173.0f, 0.0f, 512.5f);
+  const size_t laenge = zeitachsenLaenge(samples.size(), za);
+  std::vector<Q15> ganz(laenge);
+  TEST_ASSERT_EQUAL_size_t(laenge, tasteBlockAb(samples.data(), samples.size(), false, za, 0, laenge, ganz.data()));
+  Q15 block[BLOCK];
+  for (size_t n = 0; n < laenge; n += BLOCK) {
+    const size_t anzahl = tasteBlockAb(samples.data(), samples.size(), false, za, n, BLOCK, block);
+    TEST_ASSERT_EQUAL_size_t(laenge - n < BLOCK ? laenge - n : BLOCK, anzahl);
+    for (size_t j = 0; j < anzahl; ++j) TEST_ASSERT_EQUAL_INT16(ganz[n + j].roh, block[j].roh);
+  }
+}
+
+// Interpolation: höchstens 1 LSB neben der linearen Interpolation in double
+void test_interpolation_ein_lsb() {
+  const std::vector<Q15> samples = sinusSamples(500, 50.0);
+  const KanalZeitachse za = berechneZeitachse(125.0f, 0.0f, 1000.0f);
+  std::vector<Q15> aus(zeitachsenLaenge(samples.size(), za));
+  tasteBlockAb(samples.data(), samples.size(), false, za, 0, aus.size(), aus.data());
+  for (size_t n = 0; n < aus.size(); ++n) {
+    const double pos = n * 125.0 / 1000.0;
+    const size_t i = (size_t)pos;
+    const size_t j = i + 1 < samples.size() ? i + 1 : i;
+    const double exakt = samples[i].roh + (samples[j].roh - samples[i].roh) * (pos - i);
+    TEST_ASSERT_INT_WITHIN(1, lround(exakt), aus[n].roh);
+  }
+}
+
+// Schleife: über das Kanalende hinweg zwischen letztem und erstem Sample
+void test_schleife_interpoliert_zum_anfang() {
+  std::vector<Q15> samples = {Q15::ausRoh(0), Q15::ausRoh(1000), Q15::ausRoh(2000), Q15::ausRoh(3000)};
+  const KanalZeitachse za = berechneZeitachse(1.0f, 0.0f, 2.0f);   // halbe Schritte
+  Q15 aus[12];
+  TEST_ASSERT_EQUAL_size_t(12, tasteBlockAb(samples.data(), samples.size(), true, za, 0, 12, aus));
+  TEST_ASSERT_EQUAL_INT16(3000, aus[6].roh);
+  TEST_ASSERT_EQUAL_INT16(1500, aus[7].roh);   // zwischen 3000 und 0
+  TEST_ASSERT_EQUAL_INT16(0, aus[8].roh);
+  TEST_ASSERT_EQUAL_INT16(500, aus[9].roh);
+  // Ohne Schleife endet der Kanal nach dem letzten Sample
+  TEST_ASSERT_EQUAL_size_t(8, tasteBlockAb(samples.data(), samples.size(), false, za, 0, 12, aus));
+}
+
+// Zwei Kanäle mit verschiedenen Raten über 10 s Wiedergabe bei 512.5 Hz:
+// jeder Kanal erreicht sein Ende zur selben Zeit wie in der exakten Rechnung
+void test_gemischte_raten() {
+  const float takt = 512.5f;
+  const float raten[] = {250.0f, 1000.0f};
+  for (float rate : raten) {
+    const size_t groesse = (size_t)(rate * 10.0f);
+    const KanalZeitachse za = berechneZeitachse(rate, 0.0f, takt);
+    const size_t laenge = zeitachsenLaenge(groesse, za);
+    TEST_ASSERT_INT_WITHIN(1, (long)ceil(10.0 * takt), (long)laenge);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_gleicher_takt_direkt);
+  RUN_TEST(test_startversatz);
+  RUN_TEST(test_keine_drift_ueber_eine_stunde);
+  RUN_TEST(test_laenge);
+  RUN_TEST(test_bloecke_wie_am_stueck);
+  RUN_TEST(test_interpolation_ein_lsb);
+  RUN_TEST(test_schleife_interpoliert_zum_anfang);
+  RUN_TEST(test_gemischte_raten);
+  return UNITY_END();
+}
@@ -0,0 +1,83 @@
+# Build-Schritt für die Weboberfläche (PlatformIO extra_scripts, läuft vor
+# jedem Build; auch direkt mit python3 aufrufbar).
+#
+# Die Dateien aus web/ landen als Byte-Arrays in src/WebOberflaecheDaten.h
+# und damit im Flash der Firmware; die Oberfläche braucht kein SPIFFS.
+# HTML und Skript werden gzip-komprimiert. Verweise im HTML auf script.js und
+# das Logo erhalten einen Inhalts-Hash (?v=...), damit der Browser sie
+# dauerhaft cachen darf und nach einer Änderung trotzdem die neue Fassung lädt.
+
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 (von PlatformIO bereitgestellt)
+    PROJEKT = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJEKT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+QUELLE = os.path.join(PROJEKT, "web")
+ZIEL = os.path.join(PROJEKT, "src", "WebOberflaecheDaten.h")
+
+# (URL, Datei, MIME-Typ, gzip); die HTML-Seite zuletzt, wegen der Hashes.
+# Bereits komprimierte Formate (PNG) bleiben unverändert.
+DATEIEN = [
+    ("/HS-Wismar_Logo-FIW_V1_RGB.png", "HS-Wismar_Logo-FIW_V1_RGB.png", "image/png", False),
+    ("/script.js", "script.js", "application/javascript", True),
+    ("/", "HTML_Server.html", "text/html", True),
+]
+
+
+def inhalts_hash(daten):
+    return hashlib.sha1(daten).hexdigest()[:8]
+
+
+def als_c_array(name, daten):
+    zeilen = []
+    for i in range(0, len(daten), 20):
+        zeilen.append("  " + ",".join("0x%02x" % b for b in daten[i:i + 20]) + ",")
+    return "static const uint8_t %s[] PROGMEM = {\n%s\n};\n" % (name, "\n".join(zeilen))
+
+
+def main():
+    # data/ enthält nur noch vorab aufzuspielende Signaldateien, muss für buildfs aber existieren
+    os.makedirs(os.path.join(PROJEKT, "data"), exist_ok=True)
+
+    versionen = {}
+    arrays = []
+    eintraege = []
+    for index, (url, name, mime, komprimieren) in enumerate(DATEIEN):
+        with open(os.path.join(QUELLE, name), "rb") as f:
+            daten = f.read()
+        if name.endswith(".html"):
+            for verweis, version in versionen.items():
+                daten = daten.replace(verweis.encode() + b'"', ("%s?v=%s\"" % (verweis, version)).encode())
+        versionen[name] = inhalts_hash(daten)
+        roh = len(daten)
+        if komprimieren:
+            # mtime=0: gleiche Quelle ergibt byteweise gleiche Daten
+            daten = gzip.compress(daten, compresslevel=9, mtime=0)
+        array = "webDatei%d" % index
+        arrays.append(als_c_array(array, daten))
+        eintraege.append('  {"%s", "%s", %s, sizeof(%s), %s, "\\"%s\\""},   // %s: %d -> %d Bytes'
+                         % (url, mime, array, array, "true" if komprimieren else "false",
+                            versionen[name], name, roh, len(daten)))
+
+    text = ("// Erzeugt von tools/komprimiere_web.py aus web/ - nicht von Hand ändern\n"
+            "#ifndef WEBOBERFLAECHEDATEN_H\n#define WEBOBERFLAECHEDATEN_H\n\n"
+            + "\n".join(arrays)
+            + "\nstatic const WebDatei webDateien[] = {\n" + "\n".join(eintraege) + "\n};\n\n"
+            "#endif // WEBOBERFLAECHEDATEN_H\n")
+
+    # Nur bei Änderung schreiben, sonst würde jeder Build neu übersetzen
+    if os.path.exists(ZIEL):
+        with open(ZIEL, "r", encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    with open(ZIEL, "w", encoding="utf-8") as f:
+        f.write(text)
+    print("Weboberfläche eingebettet: " + ", ".join(e.split("// ")[1] for e in eintraege))
+
+
+main()
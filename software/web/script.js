@@ -1,6 +1,7 @@
 let processingComplete = false;
 
 window.onload = function () {
+    fetchChannelNames();
     fetchFileList();
     fetchStorageInfo();
     setInterval(fetchStorageInfo, 5000);
@@ -31,7 +32,7 @@ window.onload = function () {
           uploadContainer.appendChild(progressWrapper);
       
           const xhr = new XMLHttpRequest();
-          xhr.open('POST', '/upload', true);
+          xhr.open('POST', '/upload?convert=1', true);
       
           xhr.upload.onprogress = function (event) {
             if (event.lengthComputable) {
@@ -64,8 +65,9 @@ window.onload = function () {
   };
   
   let uploadedFiles = [];
+  let channelNames = ["CH_A", "CH_B", "CH_C", "CH_D"];
   let isPlaying = false;
-  const excludedFiles = ["HS-Wismar_Logo-FIW_V1_RGB.png","script.js", "HTML_Server.html","freq.cfg"];
+  const excludedFiles = ["HS-Wismar_Logo-FIW_V1_RGB.png","script.js", "HTML_Server.html","freq.cfg","wiedergabe.img","wiedergabe.tmp"];
 
     
   
@@ -108,6 +110,18 @@ window.onload = function () {
       .catch(error => console.error('Fehler beim Abrufen der Dateiliste: ', error));
   }
   
+  function fetchChannelNames() {
+    fetch('/channels')
+      .then(response => response.json())
+      .then(data => {
+        if (data.names && data.names.length > 0) {
+          channelNames = data.names;
+          displayFiles();
+        }
+      })
+      .catch(error => console.error('Fehler beim Abrufen der Kanäle: ', error));
+  }
+
   function isExcluded(filename) {
     return excludedFiles.includes(filename);
   }
@@ -149,7 +163,7 @@ window.onload = function () {
   
       const channelSelect = document.createElement("select");
       channelSelect.className = "channel-select";
-      ["CH_A", "CH_B", "CH_C", "CH_D"].forEach(ch => {
+      channelNames.forEach(ch => {
         const option = document.createElement("option");
         option.value = ch;
         option.textContent = ch;
@@ -195,14 +209,19 @@ window.onload = function () {
   function processFiles() {
     // Vor der Verarbeitung: Kanaldaten auf dem Server zurücksetzen
     fetch('/resetChannels', { method: 'POST' })
-      .then(() => {
+      .then(response => {
+        if (response.status === 409) {
+          alert('Die Wiedergabe läuft. Bitte zuerst stoppen.');
+          return;
+        }
         const selectedFiles = uploadedFiles.filter(file => file.selected);
         if (selectedFiles.length === 0) {
           alert("Keine Dateien ausgewählt. Bitte markieren Sie die gewünschten Dateien.");
           return;
         }
         document.getElementById('processingPopup2').style.display = 'block';
-        let channels = selectedFiles.map(file => ({ name: file.name, channel: file.channel }));
+        const range = document.getElementById('rangeSelect').value;
+        let channels = selectedFiles.map(file => ({ name: file.name, channel: file.channel, range: range }));
         const formData = new FormData();
         formData.append('channels', JSON.stringify(channels));
         fetch('/processFiles', {
@@ -238,7 +257,7 @@ window.onload = function () {
       table += "<tr>";
       table += `<td>${result.filename}</td>`;
       table += `<td>${result.channel}</td>`;
-      table += `<td>${result.numbers ? result.numbers.join(", ") : ""}</td>`;
+      table += `<td>${result.numbers ? result.numbers.join(", ") + (result.numbersTruncated ? ", …" : "") : ""}</td>`;
       table += `<td>${result.numberCount ?? ""}</td>`;
       table += `<td>${result.error ?? ""}</td>`;
       table += "</tr>";
@@ -417,7 +436,7 @@ window.onload = function () {
   }
 
   function saveFrequency() {
-    const freq = parseInt(document.getElementById('freqInput').value, 10);
+    const freq = parseFloat(document.getElementById('freqInput').value);
     const msg = document.getElementById('freqPopupMsg');
     if (isNaN(freq) || freq < 1 || freq > 1000) {
       msg.textContent = "Bitte eine gültige Frequenz (1-1000 Hz) eingeben.";